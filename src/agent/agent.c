@@ -0,0 +1,108 @@
+#include "agent.h"
+
+struct Agent *createAgent(const char *romPath, uint32_t seed) {
+    struct Agent *agent = (struct Agent *) malloc(sizeof(struct Agent));
+
+    agent->cpu = createCPU();
+    agent->ram = createRAM();
+    agent->rewardCount = 0;
+
+    if (RAM_LoadROM(agent->ram, romPath) < 0) {
+        free(agent->cpu);
+        free(agent->ram);
+        free(agent);
+        return NULL;
+    }
+
+    agent->cpu->seed = seed != 0 ? seed : DEFAULT_SEED;
+
+    agent->initialCPU = *agent->cpu;
+    agent->initialRAM = (struct RAM *) malloc(sizeof(struct RAM));
+    memcpy(agent->initialRAM, agent->ram, sizeof(struct RAM));
+
+    return agent;
+}
+
+int Agent_AddReward(struct Agent *agent, uint16_t address, int16_t weight) {
+    if (agent->rewardCount == AGENT_MAX_REWARDS) return -1;
+
+    agent->rewards[agent->rewardCount].address = address & (MEMORY_SIZE - 1);
+    agent->rewards[agent->rewardCount].weight = weight;
+    agent->rewardCount++;
+
+    return 0;
+}
+
+void Agent_Reset(struct Agent *agent) {
+    *agent->cpu = agent->initialCPU;
+    memcpy(agent->ram, agent->initialRAM, sizeof(struct RAM));
+}
+
+void Agent_StepBatch(struct Agent **agents, const uint16_t *actions, int count, int frames,
+                     enum ObservationFormat format, uint8_t *observations, int32_t *rewards) {
+    size_t observationSize = Agent_ObservationSize(format);
+
+    for (int i = 0; i < count; i++) {
+        struct Agent *agent = agents[i];
+
+        agent->cpu->keypad = actions[i];
+
+        for (int frame = 0; frame < frames; frame++) {
+            CPU_StepFrame(agent->cpu, agent->ram);
+        }
+        agent->ram->drawFlag = 0;
+
+        if (observations != NULL) Agent_Observe(agent, format, observations + i * observationSize);
+        if (rewards != NULL) rewards[i] = Agent_Reward(agent);
+    }
+}
+
+size_t Agent_ObservationSize(enum ObservationFormat format) {
+    return format == OBSERVATION_PACKED ? OBSERVATION_PACKED_SIZE : OBSERVATION_DOWNSAMPLED_SIZE;
+}
+
+void Agent_Observe(struct Agent *agent, enum ObservationFormat format, uint8_t *observation) {
+    const uint8_t *display = agent->ram->display;
+
+    if (format == OBSERVATION_PACKED) {
+        for (int i = 0; i < OBSERVATION_PACKED_SIZE; i++) {
+            // Gather the 8 pixels of this byte, 8 bytes at a time instead of 8 compares
+            uint64_t pixels;
+            memcpy(&pixels, display + i * 8, sizeof(uint64_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            pixels = __builtin_bswap64(pixels);
+#endif
+
+            uint64_t lit = ((pixels & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | pixels;
+            lit = (lit >> 7) & 0x0101010101010101ULL;
+
+            observation[i] = (uint8_t) ((lit * 0x8040201008040201ULL) >> 56);
+        }
+    } else {
+        for (int y = 0; y < 16; y++) {
+            const uint8_t *top = display + (y * 2) * 64;
+            const uint8_t *bottom = top + 64;
+
+            for (int x = 0; x < 32; x++) {
+                observation[y * 32 + x] = (top[x * 2] | top[x * 2 + 1] | bottom[x * 2] | bottom[x * 2 + 1]) != 0;
+            }
+        }
+    }
+}
+
+int32_t Agent_Reward(struct Agent *agent) {
+    int32_t reward = 0;
+
+    for (int i = 0; i < agent->rewardCount; i++) {
+        reward += agent->rewards[i].weight * agent->ram->memory[agent->rewards[i].address];
+    }
+
+    return reward;
+}
+
+void Agent_Free(struct Agent *agent) {
+    free(agent->cpu);
+    free(agent->ram);
+    free(agent->initialRAM);
+    free(agent);
+}
@@ -0,0 +1,77 @@
+/**
+ * @file agent.h
+ *
+ * Batched stepping API of the CHIP8 Emulator for bots and reinforcement learning agents
+ */
+
+#ifndef AGENT_H
+#define AGENT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define AGENT_MAX_REWARDS 8
+
+/**
+ * Packed: 1 bit per pixel, 8 bytes per row, leftmost pixel in the most significant bit
+ * Downsampled: 1 byte per 2x2 pixel block (32x16), set to 1 if any pixel of the block is lit
+ */
+enum ObservationFormat {
+    OBSERVATION_PACKED,
+    OBSERVATION_DOWNSAMPLED
+};
+
+#define OBSERVATION_PACKED_SIZE (DISPLAY_SIZE / 8)
+#define OBSERVATION_DOWNSAMPLED_SIZE (DISPLAY_SIZE / 4)
+
+/**
+ * Reward of an agent is the sum of weight * memory[address] over its terms
+ */
+struct RewardTerm {
+    uint16_t address;
+    int16_t weight;
+};
+
+struct Agent {
+    struct CPU *cpu;
+    struct RAM *ram;
+
+    // State right after the ROM was loaded, restored by Agent_Reset
+    struct CPU initialCPU;
+    struct RAM *initialRAM;
+
+    struct RewardTerm rewards[AGENT_MAX_REWARDS];
+    int rewardCount;
+};
+
+/**
+ * @return NULL if the ROM can not be read
+ */
+struct Agent *createAgent(const char *romPath, uint32_t seed);
+
+/**
+ * @return -1 when the agent already has AGENT_MAX_REWARDS terms
+ */
+int Agent_AddReward(struct Agent *agent, uint16_t address, int16_t weight);
+
+void Agent_Reset(struct Agent *agent);
+
+/**
+ * Holds actions[i] on the keypad of agents[i] and advances it by frames frames, then writes its observation
+ * to observations + i * Agent_ObservationSize(format) and its reward to rewards[i].
+ * Does not allocate, observations and rewards are owned by the caller; rewards may be NULL.
+ */
+void Agent_StepBatch(struct Agent **agents, const uint16_t *actions, int count, int frames,
+                     enum ObservationFormat format, uint8_t *observations, int32_t *rewards);
+
+size_t Agent_ObservationSize(enum ObservationFormat format);
+
+void Agent_Observe(struct Agent *agent, enum ObservationFormat format, uint8_t *observation);
+
+int32_t Agent_Reward(struct Agent *agent);
+
+void Agent_Free(struct Agent *agent);
+
+#endif
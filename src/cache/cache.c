@@ -0,0 +1,156 @@
+#include "cache.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void Cache_WriteHeader(struct CacheHeader *header, uint64_t memoryHash, const struct DecodedOp *table) {
+    memset(header, 0, sizeof(struct CacheHeader));
+
+    header->magic = CACHE_MAGIC;
+    header->version = CACHE_VERSION;
+    header->quirks = QUIRKS_VERSION;
+    header->entrySize = sizeof(struct DecodedOp);
+    header->memoryHash = memoryHash;
+    header->entryCount = MEMORY_SIZE;
+    header->payloadHash = RAM_Hash((const uint8_t *) table, DECODED_TABLE_SIZE, HASH_SEED);
+}
+
+int Cache_IsValid(const struct CacheHeader *header, uint64_t memoryHash) {
+    return header->magic == CACHE_MAGIC && header->version == CACHE_VERSION && header->quirks == QUIRKS_VERSION &&
+           header->entrySize == sizeof(struct DecodedOp) && header->memoryHash == memoryHash &&
+           header->entryCount == MEMORY_SIZE;
+}
+
+int Cache_IsValidPayload(const struct CacheHeader *header, const struct DecodedOp *table) {
+    if (RAM_Hash((const uint8_t *) table, DECODED_TABLE_SIZE, HASH_SEED) != header->payloadHash) return 0;
+
+    // The hash only catches damage, entries index registers and handlers without masks so their ranges are checked too
+    for (int i = 0; i < MEMORY_SIZE; i++) {
+        if (table[i].handler >= HANDLER_COUNT || table[i].x >= REGISTER_SIZE || table[i].y >= REGISTER_SIZE) return 0;
+    }
+
+    return 1;
+}
+
+#ifndef _WIN32
+
+void *Cache_Map(const char *path, size_t length) {
+    int descriptor = open(path, O_RDONLY);
+
+    if (descriptor < 0) return NULL;
+
+    struct stat status;
+    void *mapping = NULL;
+
+    if (fstat(descriptor, &status) == 0 && (size_t) status.st_size == length) {
+        mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) mapping = NULL;
+    }
+
+    close(descriptor);
+
+    return mapping;
+}
+
+int Cache_Store(const char *path, const void *data, size_t length) {
+    char temporary[CACHE_PATH_SIZE + 32];
+    snprintf(temporary, sizeof(temporary), "%s.%ld.tmp", path, (long) getpid());
+
+    int descriptor = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (descriptor < 0) return -1;
+
+    int written = write(descriptor, data, length) == (ssize_t) length;
+    close(descriptor);
+
+    // Readers only ever see complete files
+    if (!written || rename(temporary, path) != 0) {
+        unlink(temporary);
+        return -1;
+    }
+
+    return 0;
+}
+
+#endif
+
+struct TranslationCache *Cache_Open(const char *directory, struct RAM *ram) {
+    struct TranslationCache *cache = (struct TranslationCache *) malloc(sizeof(struct TranslationCache));
+    uint64_t memoryHash = RAM_Hash(ram->memory, MEMORY_SIZE, HASH_SEED);
+
+    cache->length = sizeof(struct CacheHeader) + DECODED_TABLE_SIZE;
+    cache->mapping = NULL;
+    cache->mapped = 0;
+    cache->hit = 0;
+
+#ifndef _WIN32
+    char path[CACHE_PATH_SIZE];
+    snprintf(path, sizeof(path), "%s/%016llx-%d-%d.ch8c", directory, (unsigned long long) memoryHash, CACHE_VERSION,
+             QUIRKS_VERSION);
+
+    cache->mapping = Cache_Map(path, cache->length);
+
+    struct CacheHeader *header = (struct CacheHeader *) cache->mapping;
+
+    if (header != NULL && Cache_IsValid(header, memoryHash) &&
+        Cache_IsValidPayload(header, (struct DecodedOp *) ((uint8_t *) cache->mapping + sizeof(struct CacheHeader)))) {
+        cache->mapped = 1;
+        cache->hit = 1;
+    } else {
+        if (cache->mapping != NULL) munmap(cache->mapping, cache->length);
+
+        void *buffer = malloc(cache->length);
+        struct DecodedOp *table = (struct DecodedOp *) ((uint8_t *) buffer + sizeof(struct CacheHeader));
+
+        CPU_PredecodeMemory(ram->memory, table);
+        Cache_WriteHeader((struct CacheHeader *) buffer, memoryHash, table);
+
+        mkdir(directory, 0755);
+
+        if (Cache_Store(path, buffer, cache->length) == 0) {
+            cache->mapping = Cache_Map(path, cache->length);
+        } else {
+            cache->mapping = NULL;
+        }
+
+        if (cache->mapping == NULL) {
+            printf("Translation cache not writable: %s\n", directory);
+            cache->mapping = buffer;
+        } else {
+            cache->mapped = 1;
+            free(buffer);
+        }
+    }
+#else
+    cache->mapping = malloc(cache->length);
+    struct DecodedOp *table = (struct DecodedOp *) ((uint8_t *) cache->mapping + sizeof(struct CacheHeader));
+
+    CPU_PredecodeMemory(ram->memory, table);
+    Cache_WriteHeader((struct CacheHeader *) cache->mapping, memoryHash, table);
+#endif
+
+    cache->table = (struct DecodedOp *) ((uint8_t *) cache->mapping + sizeof(struct CacheHeader));
+    ram->decoded = cache->table;
+
+    return cache;
+}
+
+void Cache_Close(struct TranslationCache *cache, struct RAM *ram) {
+    if (ram->decoded == cache->table) ram->decoded = NULL;
+
+#ifndef _WIN32
+    if (cache->mapped) {
+        munmap(cache->mapping, cache->length);
+    } else {
+        free(cache->mapping);
+    }
+#else
+    free(cache->mapping);
+#endif
+
+    free(cache);
+}
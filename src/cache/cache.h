@@ -0,0 +1,62 @@
+/**
+ * @file cache.h
+ *
+ * Persistent on-disk cache of predecoded ROMs for the CHIP8 Emulator
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define CACHE_MAGIC 0x43384843 // "CH8C"
+
+/**
+ * CACHE_VERSION: Bump when the layout of struct DecodedOp or of the file changes
+ * QUIRKS_VERSION: Bump when the semantics of any opcode change
+ */
+#define CACHE_VERSION 2
+#define QUIRKS_VERSION 1
+
+#define CACHE_PATH_SIZE 1024
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t quirks;
+    uint32_t entrySize;
+    uint64_t memoryHash;
+    uint64_t entryCount;
+
+    // Hash of the decoded table, damaged files are rebuilt
+    uint64_t payloadHash;
+};
+
+/**
+ * Cache files are named <memory hash>-<version>-<quirks>.ch8c and hold a header followed by the decoded table.
+ * They are mapped copy-on-write, so processes running the same ROM share the pages until an entry is decoded again.
+ */
+struct TranslationCache {
+    void *mapping;
+    size_t length;
+
+    struct DecodedOp *table;
+
+    // mapped: The table is backed by the cache file, otherwise by private memory
+    // hit: The file already existed and was valid
+    int mapped;
+    int hit;
+};
+
+/**
+ * Attaches the predecoded table of the memory of ram from directory, building and storing it when it is missing or stale.
+ * Falls back to a table in private memory when the directory can not be used.
+ */
+struct TranslationCache *Cache_Open(const char *directory, struct RAM *ram);
+
+void Cache_Close(struct TranslationCache *cache, struct RAM *ram);
+
+#endif
@@ -0,0 +1,25 @@
+#include "clock.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+uint64_t Clock_Now() {
+    LARGE_INTEGER counter, frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return (uint64_t) ((double) counter.QuadPart * 1e9 / (double) frequency.QuadPart);
+}
+
+#else
+#include <time.h>
+
+uint64_t Clock_Now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+#endif
@@ -0,0 +1,17 @@
+/**
+ * @file clock.h
+ *
+ * Monotonic host clock of the CHIP8 Emulator
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+/**
+ * Host time in nanoseconds on a monotonic clock, only differences are meaningful
+ */
+uint64_t Clock_Now();
+
+#endif
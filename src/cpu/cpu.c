@@ -1,19 +1,27 @@
 #include "cpu.h"
 #include "opcodes.c"
+#include "disassembler.c"
+#include "predecode.c"
 
 struct CPU *createCPU() {
     struct CPU *cpu = (struct CPU *) malloc(sizeof(struct CPU));
 
+    CPU_Init(cpu);
+
+    return cpu;
+}
+
+void CPU_Init(struct CPU *cpu) {
     cpu->pc = ROM_ALLOCATION;
+    cpu->I = 0;
     cpu->sp = 0;
     cpu->delayTimer = 0;
     cpu->soundTimer = 0;
+    cpu->keypad = 0;
+    cpu->seed = DEFAULT_SEED;
 
     memset(cpu->V, 0, sizeof(uint8_t) * REGISTER_SIZE);
-    memset(cpu->stack, 0, sizeof(uint8_t) * STACK_SIZE);
-    memset(cpu->keypad, 0, sizeof(uint8_t) * KEYPAD_SIZE);
-
-    return cpu;
+    memset(cpu->stack, 0, sizeof(uint16_t) * STACK_SIZE);
 }
 
 void CPU_Step(struct CPU *cpu, struct RAM *ram) {
@@ -27,8 +35,22 @@ void CPU_Step(struct CPU *cpu, struct RAM *ram) {
     CPU_DecodeAndExecOpCode(cpu, ram, opcode);
 }
 
+void CPU_StepFrame(struct CPU *cpu, struct RAM *ram) {
+    for (int i = 0; i < CYCLES_PER_FRAME; i++) {
+        CPU_Step(cpu, ram);
+    }
+}
+
+uint8_t CPU_Random(struct CPU *cpu) {
+    cpu->seed ^= cpu->seed << 13;
+    cpu->seed ^= cpu->seed >> 17;
+    cpu->seed ^= cpu->seed << 5;
+
+    return (uint8_t) (cpu->seed >> 24);
+}
+
 uint16_t CPU_FetchOpCode(struct CPU *cpu, struct RAM *ram) {
-    return (ram->memory[cpu->pc] << 8) | ram->memory[cpu->pc + 1];
+    return (ram->memory[MEMORY_ADDRESS(cpu, cpu->pc)] << 8) | ram->memory[MEMORY_ADDRESS(cpu, cpu->pc + 1)];
 }
 
 void CPU_DecodeAndExecOpCode(struct CPU *cpu, struct RAM *ram, uint16_t opcode) {
@@ -98,3 +120,10 @@ void CPU_DecodeAndExecOpCode(struct CPU *cpu, struct RAM *ram, uint16_t opcode)
     }
 }
 
+int CPU_CheckIndex(struct CPU *cpu, const char *area, int index, int size) {
+    if (index >= 0 && index < size) return index;
+
+    printf("Fault: %s index 0x%X out of 0x%X at PC 0x%03X (I 0x%03X, SP %d)\n", area, index, size, cpu->pc, cpu->I,
+           cpu->sp);
+    exit(1);
+}
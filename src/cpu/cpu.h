@@ -14,8 +14,26 @@
 
 #define REGISTER_SIZE 16
 #define STACK_SIZE 16
+#define STACK_MASK (STACK_SIZE - 1)
 #define KEYPAD_SIZE 16
 
+#define CYCLES_PER_FRAME 8
+#define DEFAULT_SEED 0x2545F491
+
+/**
+ * Memory, stack and display indices are wrapped by masking so a bad ROM can never reach outside the machine,
+ * without a branch on the hot path. Building with CHIP8_STRICT traps instead, reporting the fault with its PC.
+ */
+#ifdef CHIP8_STRICT
+#define MEMORY_ADDRESS(cpu, address) CPU_CheckIndex(cpu, "memory", address, MEMORY_SIZE)
+#define STACK_INDEX(cpu, index) CPU_CheckIndex(cpu, "stack", index, STACK_SIZE)
+#define DISPLAY_INDEX(cpu, index) CPU_CheckIndex(cpu, "display", index, DISPLAY_SIZE)
+#else
+#define MEMORY_ADDRESS(cpu, address) ((address) & MEMORY_MASK)
+#define STACK_INDEX(cpu, index) ((index) & STACK_MASK)
+#define DISPLAY_INDEX(cpu, index) ((index) & DISPLAY_MASK)
+#endif
+
 struct CPU {
     /**
      * Program Counter
@@ -50,16 +68,45 @@ struct CPU {
     uint8_t delayTimer;
     uint8_t soundTimer;
 
-    // Keypad
-    uint8_t keypad[16];
+    /**
+     * Keypad
+     * Bit i is set while key i is pressed
+     */
+    uint16_t keypad;
+
+    /**
+     * Random Seed
+     * State of the generator used by CXNN, kept per machine so runs are reproducible
+     */
+    uint32_t seed;
 };
 
 struct CPU *createCPU();
 
+/**
+ * Initializes a CPU in place, for machines not allocated by createCPU
+ */
+void CPU_Init(struct CPU *cpu);
+
 void CPU_Step(struct CPU *cpu, struct RAM *ram);
 
+/**
+ * Executes CYCLES_PER_FRAME instructions, one frame of the emulation
+ */
+void CPU_StepFrame(struct CPU *cpu, struct RAM *ram);
+
+/**
+ * Xorshift generator over cpu->seed
+ */
+uint8_t CPU_Random(struct CPU *cpu);
+
 uint16_t CPU_FetchOpCode(struct CPU *cpu, struct RAM *ram);
 
 void CPU_DecodeAndExecOpCode(struct CPU *cpu, struct RAM *ram, uint16_t opcode);
 
+/**
+ * Strict mode bounds check, reports the faulting instruction and exits when index is outside of size
+ */
+int CPU_CheckIndex(struct CPU *cpu, const char *area, int index, int size);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "disassembler.h"
+
+void CPU_Disassemble(uint16_t opcode, char buffer[DISASSEMBLY_SIZE]) {
+    unsigned int x = (opcode >> 8) & 0x000F;
+    unsigned int y = (opcode >> 4) & 0x000F;
+    unsigned int n = opcode & 0x000F;
+    unsigned int nn = opcode & 0x00FF;
+    unsigned int nnn = opcode & 0x0FFF;
+
+    switch (opcode & 0xF000) {
+        case 0x0000:
+            switch (nn) {
+                case 0xE0: snprintf(buffer, DISASSEMBLY_SIZE, "CLS"); return;
+                case 0xEE: snprintf(buffer, DISASSEMBLY_SIZE, "RET"); return;
+                default: break;
+            }
+            break;
+        case 0x1000: snprintf(buffer, DISASSEMBLY_SIZE, "JP 0x%03X", nnn); return;
+        case 0x2000: snprintf(buffer, DISASSEMBLY_SIZE, "CALL 0x%03X", nnn); return;
+        case 0x3000: snprintf(buffer, DISASSEMBLY_SIZE, "SE V%X, 0x%02X", x, nn); return;
+        case 0x4000: snprintf(buffer, DISASSEMBLY_SIZE, "SNE V%X, 0x%02X", x, nn); return;
+        case 0x5000: snprintf(buffer, DISASSEMBLY_SIZE, "SE V%X, V%X", x, y); return;
+        case 0x6000: snprintf(buffer, DISASSEMBLY_SIZE, "LD V%X, 0x%02X", x, nn); return;
+        case 0x7000: snprintf(buffer, DISASSEMBLY_SIZE, "ADD V%X, 0x%02X", x, nn); return;
+        case 0x8000:
+            switch (n) {
+                case 0x0: snprintf(buffer, DISASSEMBLY_SIZE, "LD V%X, V%X", x, y); return;
+                case 0x1: snprintf(buffer, DISASSEMBLY_SIZE, "OR V%X, V%X", x, y); return;
+                case 0x2: snprintf(buffer, DISASSEMBLY_SIZE, "AND V%X, V%X", x, y); return;
+                case 0x3: snprintf(buffer, DISASSEMBLY_SIZE, "XOR V%X, V%X", x, y); return;
+                case 0x4: snprintf(buffer, DISASSEMBLY_SIZE, "ADD V%X, V%X", x, y); return;
+                case 0x5: snprintf(buffer, DISASSEMBLY_SIZE, "SUB V%X, V%X", x, y); return;
+                case 0x6: snprintf(buffer, DISASSEMBLY_SIZE, "SHR V%X", x); return;
+                case 0x7: snprintf(buffer, DISASSEMBLY_SIZE, "SUBN V%X, V%X", x, y); return;
+                case 0xE: snprintf(buffer, DISASSEMBLY_SIZE, "SHL V%X", x); return;
+                default: break;
+            }
+            break;
+        case 0x9000: snprintf(buffer, DISASSEMBLY_SIZE, "SNE V%X, V%X", x, y); return;
+        case 0xA000: snprintf(buffer, DISASSEMBLY_SIZE, "LD I, 0x%03X", nnn); return;
+        case 0xB000: snprintf(buffer, DISASSEMBLY_SIZE, "JP V0, 0x%03X", nnn); return;
+        case 0xC000: snprintf(buffer, DISASSEMBLY_SIZE, "RND V%X, 0x%02X", x, nn); return;
+        case 0xD000: snprintf(buffer, DISASSEMBLY_SIZE, "DRW V%X, V%X, %u", x, y, n); return;
+        case 0xE000:
+            switch (nn) {
+                case 0x9E: snprintf(buffer, DISASSEMBLY_SIZE, "SKP V%X", x); return;
+                case 0xA1: snprintf(buffer, DISASSEMBLY_SIZE, "SKNP V%X", x); return;
+                default: break;
+            }
+            break;
+        case 0xF000:
+            switch (nn) {
+                case 0x07: snprintf(buffer, DISASSEMBLY_SIZE, "LD V%X, DT", x); return;
+                case 0x0A: snprintf(buffer, DISASSEMBLY_SIZE, "LD V%X, K", x); return;
+                case 0x15: snprintf(buffer, DISASSEMBLY_SIZE, "LD DT, V%X", x); return;
+                case 0x18: snprintf(buffer, DISASSEMBLY_SIZE, "LD ST, V%X", x); return;
+                case 0x1E: snprintf(buffer, DISASSEMBLY_SIZE, "ADD I, V%X", x); return;
+                case 0x29: snprintf(buffer, DISASSEMBLY_SIZE, "LD F, V%X", x); return;
+                case 0x33: snprintf(buffer, DISASSEMBLY_SIZE, "LD B, V%X", x); return;
+                case 0x55: snprintf(buffer, DISASSEMBLY_SIZE, "LD [I], V%X", x); return;
+                case 0x65: snprintf(buffer, DISASSEMBLY_SIZE, "LD V%X, [I]", x); return;
+                default: break;
+            }
+            break;
+        default: break;
+    }
+
+    snprintf(buffer, DISASSEMBLY_SIZE, "DW 0x%04X", opcode);
+}
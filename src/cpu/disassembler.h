@@ -0,0 +1,20 @@
+/**
+ * @file disassembler.h
+ *
+ * CHIP8 OpCode disassembler
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifndef DISASSEMBLER_H
+#define DISASSEMBLER_H
+
+#define DISASSEMBLY_SIZE 24
+
+/**
+ * Writes the mnemonic of opcode (e.g. "LD V0, 0x05"), unknown opcodes are written as "DW 0x0123"
+ */
+void CPU_Disassemble(uint16_t opcode, char buffer[DISASSEMBLY_SIZE]);
+
+#endif
@@ -9,7 +9,7 @@ void OP_00E0(struct CPU *cpu, struct RAM *ram) {
 
 void OP_00EE(struct CPU *cpu) {
     cpu->sp -= 1;
-    cpu->pc = cpu->stack[cpu->sp] + 2;
+    cpu->pc = cpu->stack[STACK_INDEX(cpu, cpu->sp)] + 2;
 }
 
 void OP_1NNN(struct CPU *cpu, uint16_t nnn) {
@@ -17,7 +17,7 @@ void OP_1NNN(struct CPU *cpu, uint16_t nnn) {
 }
 
 void OP_2NNN(struct CPU *cpu, uint16_t nnn) {
-    cpu->stack[cpu->sp] = cpu->pc;
+    cpu->stack[STACK_INDEX(cpu, cpu->sp)] = cpu->pc;
     cpu->sp += 1;
     cpu->pc = nnn;
 }
@@ -108,7 +108,7 @@ void OP_BNNN(struct CPU *cpu, uint16_t nnn) {
 }
 
 void OP_CXNN(struct CPU *cpu, uint8_t x, uint8_t nn) {
-    cpu->V[x] = (rand() % 256) & nn;
+    cpu->V[x] = CPU_Random(cpu) & nn;
     cpu->pc += 2;
 }
 
@@ -116,7 +116,7 @@ void OP_DXYN(struct CPU *cpu, struct RAM *ram, uint8_t x, uint8_t y, uint8_t n)
     cpu->V[0xF] = 0;
 
     for (int i = 0; i < n; i++) {
-        uint8_t byte = ram->memory[cpu->I + i];
+        uint8_t byte = ram->memory[MEMORY_ADDRESS(cpu, cpu->I + i)];
 
         for (int j = 0; j < 8; j++) {
             uint8_t bit = byte & (0x80 >> j);
@@ -126,7 +126,7 @@ void OP_DXYN(struct CPU *cpu, struct RAM *ram, uint8_t x, uint8_t y, uint8_t n)
             int posX = cpu->V[x] + j;
             int posY = cpu->V[y] + i;
 
-            int index = (posY * 64) + posX;
+            int index = DISPLAY_INDEX(cpu, (posY * 64) + posX);
 
             if (ram->display[index] != 0) cpu->V[0xF] = 1;
 
@@ -144,15 +144,11 @@ void OP_FX07(struct CPU *cpu, uint8_t x) {
 }
 
 void OP_FX0A(struct CPU *cpu, uint8_t x) {
-    int keyPress = 0;
-    while (keyPress == 0) {
-        for (int i = 0; i < KEYPAD_SIZE; i++) {
-            if (cpu->keypad[i] == 1) {
-                cpu->V[x] = i;
-                keyPress = 1;
-            }
-        }
-    }
+    // The keypad is only updated between frames, so wait by executing this instruction again
+    if (cpu->keypad == 0) return;
+
+    // Highest pressed key, the mask is non-zero here so the count of leading zeros is defined
+    cpu->V[x] = (uint8_t) (31 - __builtin_clz(cpu->keypad));
     cpu->pc += 2;
 }
 
@@ -180,16 +176,16 @@ void OP_FX29(struct CPU *cpu, uint8_t x) {
 void OP_FX33(struct CPU *cpu, struct RAM *ram, uint8_t x) {
     uint8_t vx = cpu->V[x];
 
-    ram->memory[cpu->I] = (vx % 1000) / 100;
-    ram->memory[cpu->I + 1] = (vx % 100) / 10;
-    ram->memory[cpu->I + 2] = (vx % 10);
+    ram->memory[MEMORY_ADDRESS(cpu, cpu->I)] = (vx % 1000) / 100;
+    ram->memory[MEMORY_ADDRESS(cpu, cpu->I + 1)] = (vx % 100) / 10;
+    ram->memory[MEMORY_ADDRESS(cpu, cpu->I + 2)] = (vx % 10);
 
     cpu->pc += 2;
 }
 
 void OP_FX55(struct CPU *cpu, struct RAM *ram, uint8_t x) {
     for (int i = 0; i <= x; i++) {
-        ram->memory[cpu->I + i] = cpu->V[i];
+        ram->memory[MEMORY_ADDRESS(cpu, cpu->I + i)] = cpu->V[i];
     }
 
     cpu->I += x + 1;
@@ -198,7 +194,7 @@ void OP_FX55(struct CPU *cpu, struct RAM *ram, uint8_t x) {
 
 void OP_FX65(struct CPU *cpu, struct RAM *ram, uint8_t x) {
     for (int i = 0; i < x; i++) {
-        cpu->V[i] = ram->memory[cpu->I + i];
+        cpu->V[i] = ram->memory[MEMORY_ADDRESS(cpu, cpu->I + i)];
     }
 
     cpu->I += x + 1;
@@ -206,9 +202,9 @@ void OP_FX65(struct CPU *cpu, struct RAM *ram, uint8_t x) {
 }
 
 void OP_EX9E(struct CPU *cpu, uint8_t x) {
-    cpu->pc += (cpu->keypad[cpu->V[x]] == 1) ? 4 : 2;
+    cpu->pc += 2 + (((cpu->keypad >> (cpu->V[x] & 0xF)) & 0x1) << 1);
 }
 
 void OP_EXA1(struct CPU *cpu, uint8_t x) {
-    cpu->pc += (cpu->keypad[cpu->V[x]] == 0) ? 4 : 2;
+    cpu->pc += 4 - (((cpu->keypad >> (cpu->V[x] & 0xF)) & 0x1) << 1);
 }
\ No newline at end of file
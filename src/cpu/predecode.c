@@ -0,0 +1,143 @@
+#include "predecode.h"
+
+struct DecodedOp CPU_Predecode(uint16_t opcode) {
+    struct DecodedOp op;
+
+    op.opcode = opcode;
+    op.handler = HANDLER_NONE;
+    op.x = (opcode >> 8) & 0x000F;
+    op.y = (opcode >> 4) & 0x000F;
+    op.nn = opcode & 0x00FF;
+    op.nnn = opcode & 0x0FFF;
+
+    switch (opcode & 0xF000) {
+        case 0x0000:
+            switch (op.nn) {
+                case 0xE0: op.handler = HANDLER_00E0; break;
+                case 0xEE: op.handler = HANDLER_00EE; break;
+                default: break;
+            }
+            break;
+        case 0x8000:
+            switch (opcode & 0x000F) {
+                case 0x0: op.handler = HANDLER_8XY0; break;
+                case 0x1: op.handler = HANDLER_8XY1; break;
+                case 0x2: op.handler = HANDLER_8XY2; break;
+                case 0x3: op.handler = HANDLER_8XY3; break;
+                case 0x4: op.handler = HANDLER_8XY4; break;
+                case 0x5: op.handler = HANDLER_8XY5; break;
+                case 0x6: op.handler = HANDLER_8XY6; break;
+                case 0x7: op.handler = HANDLER_8XY7; break;
+                case 0xE: op.handler = HANDLER_8XYE; break;
+                default: break;
+            }
+            break;
+        case 0xE000:
+            switch (op.nn) {
+                case 0x9E: op.handler = HANDLER_EX9E; break;
+                case 0xA1: op.handler = HANDLER_EXA1; break;
+                default: break;
+            }
+            break;
+        case 0xF000:
+            switch (op.nn) {
+                case 0x07: op.handler = HANDLER_FX07; break;
+                case 0x0A: op.handler = HANDLER_FX0A; break;
+                case 0x15: op.handler = HANDLER_FX15; break;
+                case 0x18: op.handler = HANDLER_FX18; break;
+                case 0x1E: op.handler = HANDLER_FX1E; break;
+                case 0x29: op.handler = HANDLER_FX29; break;
+                case 0x33: op.handler = HANDLER_FX33; break;
+                case 0x55: op.handler = HANDLER_FX55; break;
+                case 0x65: op.handler = HANDLER_FX65; break;
+                default: break;
+            }
+            break;
+        case 0x1000: op.handler = HANDLER_1NNN; break;
+        case 0x2000: op.handler = HANDLER_2NNN; break;
+        case 0x3000: op.handler = HANDLER_3XNN; break;
+        case 0x4000: op.handler = HANDLER_4XNN; break;
+        case 0x5000: op.handler = HANDLER_5XY0; break;
+        case 0x6000: op.handler = HANDLER_6XNN; break;
+        case 0x7000: op.handler = HANDLER_7XNN; break;
+        case 0x9000: op.handler = HANDLER_9XY0; break;
+        case 0xA000: op.handler = HANDLER_ANNN; break;
+        case 0xB000: op.handler = HANDLER_BNNN; break;
+        case 0xC000: op.handler = HANDLER_CXNN; break;
+        case 0xD000: op.handler = HANDLER_DXYN; break;
+        default: break;
+    }
+
+    return op;
+}
+
+void CPU_PredecodeMemory(uint8_t memory[MEMORY_SIZE], struct DecodedOp table[MEMORY_SIZE]) {
+    for (int address = 0; address < MEMORY_SIZE; address++) {
+        uint16_t opcode = (memory[address] << 8) | memory[(address + 1) & MEMORY_MASK];
+
+        table[address] = CPU_Predecode(opcode);
+    }
+}
+
+void CPU_StepDecoded(struct CPU *cpu, struct RAM *ram) {
+    if (cpu->delayTimer > 0) cpu->delayTimer -= 1;
+    if (cpu->soundTimer > 0) cpu->soundTimer -= 1;
+
+    uint16_t opcode = CPU_FetchOpCode(cpu, ram);
+    struct DecodedOp *op = &ram->decoded[MEMORY_ADDRESS(cpu, cpu->pc)];
+
+    // Decode again if the code was overwritten
+    if (op->opcode != opcode) *op = CPU_Predecode(opcode);
+
+    CPU_ExecDecoded(cpu, ram, op);
+}
+
+void CPU_StepFrameDecoded(struct CPU *cpu, struct RAM *ram) {
+    for (int i = 0; i < CYCLES_PER_FRAME; i++) {
+        CPU_StepDecoded(cpu, ram);
+    }
+}
+
+void CPU_ExecDecoded(struct CPU *cpu, struct RAM *ram, const struct DecodedOp *op) {
+    uint8_t x = op->x;
+    uint8_t y = op->y;
+    uint8_t nn = op->nn;
+
+    switch (op->handler) {
+        case HANDLER_00E0: return OP_00E0(cpu, ram);
+        case HANDLER_00EE: return OP_00EE(cpu);
+        case HANDLER_1NNN: return OP_1NNN(cpu, op->nnn);
+        case HANDLER_2NNN: return OP_2NNN(cpu, op->nnn);
+        case HANDLER_3XNN: return OP_3XNN(cpu, x, nn);
+        case HANDLER_4XNN: return OP_4XNN(cpu, x, nn);
+        case HANDLER_5XY0: return OP_5XY0(cpu, x, y);
+        case HANDLER_6XNN: return OP_6XNN(cpu, x, nn);
+        case HANDLER_7XNN: return OP_7XNN(cpu, x, nn);
+        case HANDLER_8XY0: return OP_8XY0(cpu, x, y);
+        case HANDLER_8XY1: return OP_8XY1(cpu, x, y);
+        case HANDLER_8XY2: return OP_8XY2(cpu, x, y);
+        case HANDLER_8XY3: return OP_8XY3(cpu, x, y);
+        case HANDLER_8XY4: return OP_8XY4(cpu, x, y);
+        case HANDLER_8XY5: return OP_8XY5(cpu, x, y);
+        case HANDLER_8XY6: return OP_8XY6(cpu, x);
+        case HANDLER_8XY7: return OP_8XY7(cpu, x, y);
+        case HANDLER_8XYE: return OP_8XYE(cpu, x);
+        case HANDLER_9XY0: return OP_9XY0(cpu, x, y);
+        case HANDLER_ANNN: return OP_ANNN(cpu, op->nnn);
+        case HANDLER_BNNN: return OP_BNNN(cpu, op->nnn);
+        case HANDLER_CXNN: return OP_CXNN(cpu, x, nn);
+        case HANDLER_DXYN: return OP_DXYN(cpu, ram, x, y, nn & 0x000F);
+        case HANDLER_EX9E: return OP_EX9E(cpu, x);
+        case HANDLER_EXA1: return OP_EXA1(cpu, x);
+        case HANDLER_FX07: return OP_FX07(cpu, x);
+        case HANDLER_FX0A: return OP_FX0A(cpu, x);
+        case HANDLER_FX15: return OP_FX15(cpu, x);
+        case HANDLER_FX18: return OP_FX18(cpu, x);
+        case HANDLER_FX1E: return OP_FX1E(cpu, x);
+        case HANDLER_FX29: return OP_FX29(cpu, x);
+        case HANDLER_FX33: return OP_FX33(cpu, ram, x);
+        case HANDLER_FX55: return OP_FX55(cpu, ram, x);
+        case HANDLER_FX65: return OP_FX65(cpu, ram, x);
+        default: break;
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file predecode.h
+ *
+ * Predecoded instruction table of the CHIP8 Emulator
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "cpu.h"
+
+#ifndef PREDECODE_H
+#define PREDECODE_H
+
+enum DecodedHandler {
+    HANDLER_NONE,
+    HANDLER_00E0, HANDLER_00EE,
+    HANDLER_1NNN, HANDLER_2NNN, HANDLER_3XNN, HANDLER_4XNN, HANDLER_5XY0, HANDLER_6XNN, HANDLER_7XNN,
+    HANDLER_8XY0, HANDLER_8XY1, HANDLER_8XY2, HANDLER_8XY3, HANDLER_8XY4, HANDLER_8XY5, HANDLER_8XY6,
+    HANDLER_8XY7, HANDLER_8XYE,
+    HANDLER_9XY0, HANDLER_ANNN, HANDLER_BNNN, HANDLER_CXNN, HANDLER_DXYN,
+    HANDLER_EX9E, HANDLER_EXA1,
+    HANDLER_FX07, HANDLER_FX0A, HANDLER_FX15, HANDLER_FX18, HANDLER_FX1E, HANDLER_FX29, HANDLER_FX33,
+    HANDLER_FX55, HANDLER_FX65,
+    HANDLER_COUNT
+};
+
+/**
+ * Instruction at one memory address, decoded once
+ * The opcode it was decoded from is kept, a mismatch with memory means the code was overwritten
+ */
+struct DecodedOp {
+    uint16_t opcode;
+    uint8_t handler;
+    uint8_t x;
+    uint8_t y;
+    uint8_t nn;
+    uint16_t nnn;
+};
+
+/**
+ * Table with one entry per memory address
+ */
+#define DECODED_TABLE_SIZE (sizeof(struct DecodedOp) * MEMORY_SIZE)
+
+struct DecodedOp CPU_Predecode(uint16_t opcode);
+
+/**
+ * Decodes the instruction starting at every address of memory into table
+ */
+void CPU_PredecodeMemory(uint8_t memory[MEMORY_SIZE], struct DecodedOp table[MEMORY_SIZE]);
+
+/**
+ * Same result as CPU_Step, executes from ram->decoded which must be set
+ * Still compares the opcode in memory with the entry, tables are shared between copies of a machine
+ * and memory is written by FX33, FX55 and external tools without updating them
+ */
+void CPU_StepDecoded(struct CPU *cpu, struct RAM *ram);
+
+/**
+ * CPU_StepFrame through CPU_StepDecoded
+ */
+void CPU_StepFrameDecoded(struct CPU *cpu, struct RAM *ram);
+
+/**
+ * Same semantics as CPU_DecodeAndExecOpCode for the opcode op was decoded from
+ */
+void CPU_ExecDecoded(struct CPU *cpu, struct RAM *ram, const struct DecodedOp *op);
+
+#endif
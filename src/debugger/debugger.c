@@ -0,0 +1,472 @@
+#include "debugger.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// A client that leaves before reading its reply must not raise SIGPIPE, see Debugger_ListenSocket
+#ifdef MSG_NOSIGNAL
+#define DEBUGGER_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define DEBUGGER_SEND_FLAGS 0
+#endif
+#endif
+
+struct Debugger *createDebugger() {
+    struct Debugger *debugger = (struct Debugger *) malloc(sizeof(struct Debugger));
+
+    memset(debugger, 0, sizeof(struct Debugger));
+    debugger->input = -1;
+    debugger->listener = -1;
+
+    return debugger;
+}
+
+void Debugger_Print(struct Debugger *debugger, const char *format, ...) {
+    char buffer[DEBUGGER_LINE_SIZE * 4];
+    va_list arguments;
+
+    va_start(arguments, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, arguments);
+    va_end(arguments);
+
+    if (length <= 0) return;
+    if (length >= (int) sizeof(buffer)) length = sizeof(buffer) - 1;
+
+#ifndef _WIN32
+    if (debugger->listener >= 0) {
+        // EPIPE or a reset means the client left, drop it like an end of input
+        if (debugger->input >= 0 && send(debugger->input, buffer, length, DEBUGGER_SEND_FLAGS) < 0) {
+            close(debugger->input);
+            debugger->input = -1;
+            debugger->lineLength = 0;
+        }
+        return;
+    }
+#endif
+
+    fwrite(buffer, 1, length, stdout);
+    fflush(stdout);
+}
+
+#ifndef _WIN32
+
+void Debugger_ListenStdin(struct Debugger *debugger) {
+    debugger->input = STDIN_FILENO;
+}
+
+int Debugger_ListenSocket(struct Debugger *debugger, const char *path) {
+    struct sockaddr_un address;
+
+    if (strlen(path) >= sizeof(address.sun_path)) return -1;
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) return -1;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    unlink(path);
+
+    if (bind(listener, (struct sockaddr *) &address, sizeof(address)) < 0 || listen(listener, 1) < 0) {
+        close(listener);
+        return -1;
+    }
+
+    fcntl(listener, F_SETFL, O_NONBLOCK);
+    debugger->listener = listener;
+
+#ifndef MSG_NOSIGNAL
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    return 0;
+}
+
+void Debugger_Poll(struct Debugger *debugger, struct CPU *cpu, struct RAM *ram) {
+    if (debugger->listener >= 0 && debugger->input < 0) {
+        debugger->input = accept(debugger->listener, NULL, NULL);
+        if (debugger->input >= 0) Debugger_Print(debugger, "CHIP8 debugger, type help for commands\n");
+    }
+
+    if (debugger->input < 0) return;
+
+    struct pollfd request = {debugger->input, POLLIN, 0};
+
+    while (poll(&request, 1, 0) > 0 && (request.revents & (POLLIN | POLLHUP))) {
+        char byte;
+
+        if (read(debugger->input, &byte, 1) != 1) {
+            // End of stdin or the client left, keep running without commands
+            if (debugger->listener >= 0) close(debugger->input);
+            debugger->input = -1;
+            debugger->lineLength = 0;
+            return;
+        }
+
+        if (byte == '\n' || debugger->lineLength == DEBUGGER_LINE_SIZE - 1) {
+            debugger->line[debugger->lineLength] = '\0';
+            debugger->lineLength = 0;
+            Debugger_Command(debugger, cpu, ram, debugger->line);
+
+            if (debugger->input < 0) return;
+        } else if (byte != '\r') {
+            debugger->line[debugger->lineLength++] = byte;
+        }
+    }
+}
+
+void Debugger_Close(struct Debugger *debugger) {
+    if (debugger->listener >= 0) {
+        if (debugger->input >= 0) close(debugger->input);
+        close(debugger->listener);
+    }
+
+    free(debugger);
+}
+
+#else
+
+void Debugger_ListenStdin(struct Debugger *debugger) {
+    printf("Debugger commands are not supported on this platform\n");
+}
+
+int Debugger_ListenSocket(struct Debugger *debugger, const char *path) {
+    return -1;
+}
+
+void Debugger_Poll(struct Debugger *debugger, struct CPU *cpu, struct RAM *ram) {
+}
+
+void Debugger_Close(struct Debugger *debugger) {
+    free(debugger);
+}
+
+#endif
+
+int Debugger_IsArmed(struct Debugger *debugger) {
+    return debugger->paused || debugger->stepInstructions > 0 || debugger->stepFrames > 0 ||
+           debugger->breakpointCount > 0 || debugger->watchpointCount > 0 || debugger->conditionCount > 0;
+}
+
+uint16_t Debugger_Register(struct CPU *cpu, uint8_t reg) {
+    switch (reg) {
+        case DEBUG_REGISTER_I: return cpu->I;
+        case DEBUG_REGISTER_PC: return cpu->pc;
+        case DEBUG_REGISTER_SP: return cpu->sp;
+        case DEBUG_REGISTER_DT: return cpu->delayTimer;
+        case DEBUG_REGISTER_ST: return cpu->soundTimer;
+        default: return cpu->V[reg & 0xF];
+    }
+}
+
+int Debugger_ParseRegister(const char *name, uint8_t *reg) {
+    const char *names[] = {"I", "PC", "SP", "DT", "ST"};
+
+    if ((name[0] == 'V' || name[0] == 'v') && name[1] != '\0' && name[2] == '\0') {
+        char *end;
+        unsigned long index = strtoul(name + 1, &end, 16);
+
+        if (*end != '\0') return -1;
+
+        *reg = (uint8_t) index;
+        return 0;
+    }
+
+    for (int i = 0; i < 5; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *reg = DEBUG_REGISTER_I + i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Number of bytes the opcode reads and writes starting at I, the instruction fetch is not counted
+ */
+void Debugger_Accesses(uint16_t opcode, int *readLength, int *writeLength) {
+    uint8_t x = (opcode >> 8) & 0x000F;
+
+    *readLength = 0;
+    *writeLength = 0;
+
+    if ((opcode & 0xF000) == 0xD000) {
+        *readLength = opcode & 0x000F;
+    } else if ((opcode & 0xF000) == 0xF000) {
+        switch (opcode & 0x00FF) {
+            case 0x33: *writeLength = 3; break;
+            case 0x55: *writeLength = x + 1; break;
+            case 0x65: *readLength = x; break;
+            default: break;
+        }
+    }
+}
+
+int Debugger_Watched(struct Debugger *debugger, uint16_t start, int length, uint8_t kind) {
+    for (int w = 0; w < debugger->watchpointCount; w++) {
+        struct Watchpoint *watch = &debugger->watchpoints[w];
+
+        if (!(watch->kind & kind)) continue;
+
+        for (int i = 0; i < length; i++) {
+            uint16_t offset = ((start + i) - watch->address) & MEMORY_MASK;
+
+            if (offset < watch->length) return w;
+        }
+    }
+
+    return -1;
+}
+
+void Debugger_Pause(struct Debugger *debugger, struct CPU *cpu, struct RAM *ram, const char *reason) {
+    char disassembly[DISASSEMBLY_SIZE];
+    CPU_Disassemble(CPU_FetchOpCode(cpu, ram), disassembly);
+
+    debugger->paused = 1;
+    debugger->stepInstructions = 0;
+    debugger->stepFrames = 0;
+
+    Debugger_Print(debugger, "%s at PC 0x%03X: %s\n", reason, cpu->pc, disassembly);
+}
+
+int Debugger_Step(struct Debugger *debugger, struct CPU *cpu, struct RAM *ram) {
+    if (debugger->paused) return 0;
+
+    uint16_t opcode = CPU_FetchOpCode(cpu, ram);
+
+    if (!debugger->resuming) {
+        for (int i = 0; i < debugger->breakpointCount; i++) {
+            if (debugger->breakpoints[i] == cpu->pc) {
+                Debugger_Pause(debugger, cpu, ram, "Breakpoint");
+                return 0;
+            }
+        }
+
+        if (debugger->watchpointCount > 0) {
+            int readLength, writeLength;
+            Debugger_Accesses(opcode, &readLength, &writeLength);
+
+            int watch = Debugger_Watched(debugger, cpu->I, readLength, WATCH_READ);
+            if (watch >= 0) {
+                Debugger_Pause(debugger, cpu, ram, "Read watchpoint");
+                return 0;
+            }
+
+            watch = Debugger_Watched(debugger, cpu->I, writeLength, WATCH_WRITE);
+            if (watch >= 0) {
+                Debugger_Pause(debugger, cpu, ram, "Write watchpoint");
+                return 0;
+            }
+        }
+    }
+
+    debugger->resuming = 0;
+
+    CPU_Step(cpu, ram);
+
+    for (int i = 0; i < debugger->conditionCount; i++) {
+        struct Condition *condition = &debugger->conditions[i];
+        uint16_t value = Debugger_Register(cpu, condition->reg);
+        int isTrue;
+
+        switch (condition->operator) {
+            case CONDITION_EQUAL: isTrue = value == condition->value; break;
+            case CONDITION_NOT_EQUAL: isTrue = value != condition->value; break;
+            case CONDITION_LESS: isTrue = value < condition->value; break;
+            default: isTrue = value > condition->value; break;
+        }
+
+        int triggered = isTrue && !condition->wasTrue;
+        condition->wasTrue = (uint8_t) isTrue;
+
+        if (triggered) {
+            Debugger_Pause(debugger, cpu, ram, "Condition");
+            return 0;
+        }
+    }
+
+    if (debugger->stepInstructions > 0 && --debugger->stepInstructions == 0) {
+        Debugger_Pause(debugger, cpu, ram, "Step");
+        return 0;
+    }
+
+    return 1;
+}
+
+void Debugger_StepFrame(struct Debugger *debugger, struct CPU *cpu, struct RAM *ram) {
+    if (debugger->paused) return;
+
+    for (int i = 0; i < CYCLES_PER_FRAME; i++) {
+        if (!Debugger_Step(debugger, cpu, ram)) return;
+    }
+
+    if (debugger->stepFrames > 0 && --debugger->stepFrames == 0) {
+        Debugger_Pause(debugger, cpu, ram, "Frame");
+    }
+}
+
+void Debugger_Resume(struct Debugger *debugger, long instructions, long frames) {
+    debugger->paused = 0;
+    debugger->resuming = 1;
+    debugger->stepInstructions = instructions;
+    debugger->stepFrames = frames;
+}
+
+void Debugger_Help(struct Debugger *debugger) {
+    Debugger_Print(debugger,
+                   "break <address>                 Pause before executing address\n"
+                   "delete <address>                Remove the breakpoint at address\n"
+                   "watch <r|w|rw> <address> [len]  Pause before memory is read or written\n"
+                   "unwatch <address>               Remove the watchpoint starting at address\n"
+                   "cond <register> <op> <value>    Pause when V0-VF, I, PC, SP, DT or ST becomes ==, !=, < or > value\n"
+                   "uncond                          Remove all conditions\n"
+                   "clear                           Remove all breakpoints, watchpoints and conditions\n"
+                   "pause | continue                Pause or resume emulation\n"
+                   "step [n] | frame [n]            Run n instructions or frames, then pause\n"
+                   "regs | mem <address> [len]      Print registers or memory\n"
+                   "disasm [address] [count]        Disassemble instructions, from PC by default\n"
+                   "quit                            Close the emulator\n");
+}
+
+void Debugger_PrintRegisters(struct Debugger *debugger, struct CPU *cpu) {
+    Debugger_Print(debugger, "PC %03X  I %03X  SP %X  DT %02X  ST %02X  KEYS %04X\n", cpu->pc, cpu->I, cpu->sp,
+                   cpu->delayTimer, cpu->soundTimer, cpu->keypad);
+
+    for (int i = 0; i < REGISTER_SIZE; i++) {
+        Debugger_Print(debugger, "V%X %02X%s", i, cpu->V[i], (i % 8 == 7) ? "\n" : "  ");
+    }
+}
+
+void Debugger_PrintMemory(struct Debugger *debugger, struct RAM *ram, unsigned int address, unsigned int length) {
+    for (unsigned int row = 0; row < length; row += 16) {
+        char line[16 * 3 + 1];
+        int position = 0;
+
+        for (unsigned int i = row; i < row + 16 && i < length; i++) {
+            position += snprintf(line + position, sizeof(line) - position, " %02X",
+                                 ram->memory[(address + i) & MEMORY_MASK]);
+        }
+
+        Debugger_Print(debugger, "%03X:%s\n", (address + row) & MEMORY_MASK, line);
+    }
+}
+
+void Debugger_PrintDisassembly(struct Debugger *debugger, struct CPU *cpu, struct RAM *ram, unsigned int address,
+                               unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+        uint16_t at = (address + i * 2) & MEMORY_MASK;
+        uint16_t opcode = (ram->memory[at] << 8) | ram->memory[(at + 1) & MEMORY_MASK];
+        char disassembly[DISASSEMBLY_SIZE];
+
+        CPU_Disassemble(opcode, disassembly);
+        Debugger_Print(debugger, "%s%03X: %04X  %s\n", at == cpu->pc ? ">" : " ", at, opcode, disassembly);
+    }
+}
+
+void Debugger_Command(struct Debugger *debugger, struct CPU *cpu, struct RAM *ram, char *command) {
+    char name[16] = "";
+    char first[16] = "";
+    char second[16] = "";
+    char third[16] = "";
+
+    int count = sscanf(command, "%15s %15s %15s %15s", name, first, second, third);
+
+    if (count <= 0) return;
+
+    unsigned int address = (unsigned int) strtoul(first, NULL, 0);
+
+    if (strcmp(name, "help") == 0) {
+        Debugger_Help(debugger);
+    } else if (strcmp(name, "break") == 0 && count >= 2) {
+        if (debugger->breakpointCount == DEBUGGER_MAX_BREAKPOINTS) {
+            Debugger_Print(debugger, "Too many breakpoints\n");
+            return;
+        }
+        debugger->breakpoints[debugger->breakpointCount++] = (uint16_t) (address & MEMORY_MASK);
+        Debugger_Print(debugger, "Breakpoint at 0x%03X\n", address & MEMORY_MASK);
+    } else if (strcmp(name, "delete") == 0 && count >= 2) {
+        for (int i = 0; i < debugger->breakpointCount; i++) {
+            if (debugger->breakpoints[i] == (address & MEMORY_MASK)) {
+                debugger->breakpoints[i--] = debugger->breakpoints[--debugger->breakpointCount];
+            }
+        }
+    } else if (strcmp(name, "watch") == 0 && count >= 3) {
+        if (debugger->watchpointCount == DEBUGGER_MAX_WATCHPOINTS) {
+            Debugger_Print(debugger, "Too many watchpoints\n");
+            return;
+        }
+
+        uint8_t kind = (strchr(first, 'r') ? WATCH_READ : 0) | (strchr(first, 'w') ? WATCH_WRITE : 0);
+
+        // A watchpoint that never fires would still keep every step on the instrumented path
+        if (kind == 0) {
+            Debugger_Print(debugger, "Watch kind must contain r or w: %s\n", first);
+            return;
+        }
+
+        struct Watchpoint *watch = &debugger->watchpoints[debugger->watchpointCount++];
+        watch->kind = kind;
+        watch->address = (uint16_t) (strtoul(second, NULL, 0) & MEMORY_MASK);
+        watch->length = (uint16_t) (count >= 4 ? strtoul(third, NULL, 0) : 1);
+        Debugger_Print(debugger, "Watchpoint on 0x%03X, %u bytes\n", watch->address, watch->length);
+    } else if (strcmp(name, "unwatch") == 0 && count >= 2) {
+        for (int i = 0; i < debugger->watchpointCount; i++) {
+            if (debugger->watchpoints[i].address == (address & MEMORY_MASK)) {
+                debugger->watchpoints[i--] = debugger->watchpoints[--debugger->watchpointCount];
+            }
+        }
+    } else if (strcmp(name, "cond") == 0 && count >= 4) {
+        const char *operators[] = {"==", "!=", "<", ">"};
+        struct Condition condition;
+
+        condition.operator = 0xFF;
+        for (int i = 0; i < 4; i++) {
+            if (strcmp(second, operators[i]) == 0) condition.operator = (uint8_t) i;
+        }
+
+        if (Debugger_ParseRegister(first, &condition.reg) < 0 || condition.operator == 0xFF) {
+            Debugger_Print(debugger, "Invalid condition\n");
+            return;
+        }
+        if (debugger->conditionCount == DEBUGGER_MAX_CONDITIONS) {
+            Debugger_Print(debugger, "Too many conditions\n");
+            return;
+        }
+
+        condition.value = (uint16_t) strtoul(third, NULL, 0);
+        condition.wasTrue = 0;
+        debugger->conditions[debugger->conditionCount++] = condition;
+    } else if (strcmp(name, "uncond") == 0) {
+        debugger->conditionCount = 0;
+    } else if (strcmp(name, "clear") == 0) {
+        debugger->breakpointCount = 0;
+        debugger->watchpointCount = 0;
+        debugger->conditionCount = 0;
+    } else if (strcmp(name, "pause") == 0) {
+        Debugger_Pause(debugger, cpu, ram, "Paused");
+    } else if (strcmp(name, "continue") == 0) {
+        Debugger_Resume(debugger, 0, 0);
+    } else if (strcmp(name, "step") == 0) {
+        Debugger_Resume(debugger, count >= 2 && address > 0 ? (long) address : 1, 0);
+    } else if (strcmp(name, "frame") == 0) {
+        Debugger_Resume(debugger, 0, count >= 2 && address > 0 ? (long) address : 1);
+    } else if (strcmp(name, "regs") == 0) {
+        Debugger_PrintRegisters(debugger, cpu);
+    } else if (strcmp(name, "mem") == 0 && count >= 2) {
+        Debugger_PrintMemory(debugger, ram, address, count >= 3 ? (unsigned int) strtoul(second, NULL, 0) : 16);
+    } else if (strcmp(name, "disasm") == 0) {
+        Debugger_PrintDisassembly(debugger, cpu, ram, count >= 2 ? address : cpu->pc,
+                                  count >= 3 ? (unsigned int) strtoul(second, NULL, 0) : 8);
+    } else if (strcmp(name, "quit") == 0) {
+        debugger->quit = 1;
+    } else {
+        Debugger_Print(debugger, "Unknown command: %s, type help for commands\n", name);
+    }
+}
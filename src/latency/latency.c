@@ -0,0 +1,63 @@
+#include "latency.h"
+
+struct LatencyTracker *createLatencyTracker() {
+    struct LatencyTracker *tracker = (struct LatencyTracker *) malloc(sizeof(struct LatencyTracker));
+
+    tracker->pendingCount = 0;
+    tracker->samples = (uint64_t *) malloc(sizeof(uint64_t) * LATENCY_MAX_SAMPLES);
+    tracker->sampleCount = 0;
+
+    return tracker;
+}
+
+void Latency_KeyEvent(struct LatencyTracker *tracker, uint64_t timestamp) {
+    // Keep the oldest events when flooded, they are the ones a changed frame answers first
+    if (tracker->pendingCount == LATENCY_MAX_PENDING) return;
+
+    tracker->pending[tracker->pendingCount++] = timestamp;
+}
+
+void Latency_FramePresented(struct LatencyTracker *tracker, uint64_t timestamp, int changed) {
+    if (!changed) return;
+
+    for (int i = 0; i < tracker->pendingCount; i++) {
+        if (tracker->sampleCount == LATENCY_MAX_SAMPLES) break;
+
+        uint64_t event = tracker->pending[i];
+        tracker->samples[tracker->sampleCount++] = timestamp > event ? timestamp - event : 0;
+    }
+
+    tracker->pendingCount = 0;
+}
+
+int compareSamples(const void *a, const void *b) {
+    uint64_t left = *(const uint64_t *) a;
+    uint64_t right = *(const uint64_t *) b;
+
+    return (left > right) - (left < right);
+}
+
+void Latency_Report(struct LatencyTracker *tracker, FILE *stream) {
+    if (tracker->sampleCount == 0) {
+        fprintf(stream, "Input latency: no samples\n");
+        return;
+    }
+
+    qsort(tracker->samples, tracker->sampleCount, sizeof(uint64_t), compareSamples);
+
+    const int percentiles[] = {50, 90, 95, 99};
+
+    fprintf(stream, "Input latency (%d samples):", tracker->sampleCount);
+
+    for (int i = 0; i < 4; i++) {
+        int index = (tracker->sampleCount - 1) * percentiles[i] / 100;
+        fprintf(stream, " p%d %.2f ms", percentiles[i], tracker->samples[index] / 1e6);
+    }
+
+    fprintf(stream, " max %.2f ms\n", tracker->samples[tracker->sampleCount - 1] / 1e6);
+}
+
+void Latency_Free(struct LatencyTracker *tracker) {
+    free(tracker->samples);
+    free(tracker);
+}
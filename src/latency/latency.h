@@ -0,0 +1,44 @@
+/**
+ * @file latency.h
+ *
+ * Input-to-photon latency measurement of the CHIP8 Emulator
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LATENCY_MAX_PENDING 64
+#define LATENCY_MAX_SAMPLES 65536
+
+/**
+ * Every key event waits in pending until the first presented frame whose display differs from the
+ * previous presented one, the time between both is then recorded as one sample.
+ * Timestamps are host nanoseconds from any monotonic clock.
+ */
+struct LatencyTracker {
+    uint64_t pending[LATENCY_MAX_PENDING];
+    int pendingCount;
+
+    uint64_t *samples;
+    int sampleCount;
+};
+
+struct LatencyTracker *createLatencyTracker();
+
+void Latency_KeyEvent(struct LatencyTracker *tracker, uint64_t timestamp);
+
+void Latency_FramePresented(struct LatencyTracker *tracker, uint64_t timestamp, int changed);
+
+/**
+ * Prints sample count and percentiles in milliseconds
+ */
+void Latency_Report(struct LatencyTracker *tracker, FILE *stream);
+
+void Latency_Free(struct LatencyTracker *tracker);
+
+#endif
@@ -0,0 +1,302 @@
+#include "lockstep.h"
+
+uint64_t Lockstep_HashState(struct CPU *cpu, struct RAM *ram) {
+    // Field by field, padding of the structs is not part of the state
+    uint8_t registers[12];
+    registers[0] = (uint8_t) cpu->pc;
+    registers[1] = (uint8_t) (cpu->pc >> 8);
+    registers[2] = (uint8_t) cpu->I;
+    registers[3] = (uint8_t) (cpu->I >> 8);
+    registers[4] = cpu->sp;
+    registers[5] = cpu->delayTimer;
+    registers[6] = cpu->soundTimer;
+    registers[7] = (uint8_t) ram->drawFlag;
+    registers[8] = (uint8_t) cpu->seed;
+    registers[9] = (uint8_t) (cpu->seed >> 8);
+    registers[10] = (uint8_t) (cpu->seed >> 16);
+    registers[11] = (uint8_t) (cpu->seed >> 24);
+
+    uint64_t hash = RAM_Hash(registers, sizeof(registers), HASH_SEED);
+    hash = RAM_Hash(cpu->V, REGISTER_SIZE, hash);
+    hash = RAM_Hash((const uint8_t *) cpu->stack, sizeof(cpu->stack), hash);
+    hash = RAM_Hash(ram->memory, MEMORY_SIZE, hash);
+    hash = RAM_Hash(ram->display, DISPLAY_SIZE, hash);
+
+    return hash;
+}
+
+/**
+ * Names are at most 15 characters, so the widest line with two 32-bit values fits its slot
+ */
+void Lockstep_AddDifference(struct Divergence *divergence, const char *name, unsigned reference, unsigned candidate) {
+    if (divergence->differenceCount == LOCKSTEP_MAX_DIFFERENCES) return;
+
+    snprintf(divergence->differences[divergence->differenceCount++], sizeof(divergence->differences[0]),
+             "%.15s: reference 0x%X candidate 0x%X", name, reference, candidate);
+}
+
+/**
+ * Lists the differing fields into divergence, or only counts them when divergence is NULL
+ * @return Number of differing fields, memory and display count once per byte
+ */
+int Lockstep_Diff(struct Lockstep *lockstep, struct Divergence *divergence) {
+    struct CPU *reference = &lockstep->referenceCPU;
+    struct CPU *candidate = &lockstep->candidateCPU;
+    struct RAM *referenceRAM = lockstep->referenceRAM;
+    struct RAM *candidateRAM = lockstep->candidateRAM;
+    struct Divergence scratch;
+    char name[32];
+    int count = 0;
+
+    if (divergence == NULL) divergence = &scratch;
+    divergence->differenceCount = 0;
+
+#define LOCKSTEP_FIELD(label, field)                                                                               \
+    if (reference->field != candidate->field) {                                                                    \
+        Lockstep_AddDifference(divergence, label, reference->field, candidate->field);                             \
+        count++;                                                                                                   \
+    }
+
+    LOCKSTEP_FIELD("PC", pc)
+    LOCKSTEP_FIELD("I", I)
+    LOCKSTEP_FIELD("SP", sp)
+    LOCKSTEP_FIELD("DT", delayTimer)
+    LOCKSTEP_FIELD("ST", soundTimer)
+    LOCKSTEP_FIELD("Keypad", keypad)
+    LOCKSTEP_FIELD("Seed", seed)
+
+#undef LOCKSTEP_FIELD
+
+    for (int i = 0; i < REGISTER_SIZE; i++) {
+        if (reference->V[i] == candidate->V[i]) continue;
+
+        snprintf(name, sizeof(name), "V%X", i);
+        Lockstep_AddDifference(divergence, name, reference->V[i], candidate->V[i]);
+        count++;
+    }
+
+    for (int i = 0; i < STACK_SIZE; i++) {
+        if (reference->stack[i] == candidate->stack[i]) continue;
+
+        snprintf(name, sizeof(name), "Stack[%d]", i);
+        Lockstep_AddDifference(divergence, name, reference->stack[i], candidate->stack[i]);
+        count++;
+    }
+
+    if (referenceRAM->drawFlag != candidateRAM->drawFlag) {
+        Lockstep_AddDifference(divergence, "DrawFlag", referenceRAM->drawFlag, candidateRAM->drawFlag);
+        count++;
+    }
+
+    if (memcmp(referenceRAM->memory, candidateRAM->memory, MEMORY_SIZE) != 0) {
+        for (int i = 0; i < MEMORY_SIZE; i++) {
+            if (referenceRAM->memory[i] == candidateRAM->memory[i]) continue;
+
+            snprintf(name, sizeof(name), "Memory[0x%03X]", i);
+            Lockstep_AddDifference(divergence, name, referenceRAM->memory[i], candidateRAM->memory[i]);
+            count++;
+        }
+    }
+
+    if (memcmp(referenceRAM->display, candidateRAM->display, DISPLAY_SIZE) != 0) {
+        for (int i = 0; i < DISPLAY_SIZE; i++) {
+            if (referenceRAM->display[i] == candidateRAM->display[i]) continue;
+
+            snprintf(name, sizeof(name), "Display[%d,%d]", i % 64, i / 64);
+            Lockstep_AddDifference(divergence, name, referenceRAM->display[i], candidateRAM->display[i]);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+int Lockstep_Matches(struct Lockstep *lockstep) {
+    if (lockstep->mode == LOCKSTEP_HASH) {
+        return Lockstep_HashState(&lockstep->referenceCPU, lockstep->referenceRAM) ==
+               Lockstep_HashState(&lockstep->candidateCPU, lockstep->candidateRAM);
+    }
+
+    return Lockstep_Diff(lockstep, NULL) == 0;
+}
+
+/**
+ * Copies the machine into a RAM that keeps its own decoded table, the table belongs to the engine not the state
+ */
+void Lockstep_CopyRAM(struct RAM *destination, struct RAM *source) {
+    struct DecodedOp *decoded = destination->decoded;
+
+    memcpy(destination, source, sizeof(struct RAM));
+    destination->decoded = decoded;
+}
+
+void Lockstep_Checkpoint(struct Lockstep *lockstep) {
+    lockstep->checkpointCPU = lockstep->referenceCPU;
+    Lockstep_CopyRAM(lockstep->checkpointRAM, lockstep->referenceRAM);
+    lockstep->checkpointInstruction = lockstep->instructions;
+    lockstep->keypadLogLength = 0;
+}
+
+/**
+ * Replays from the last checkpoint one instruction at a time up to the current instruction
+ * and records the first instruction after which the states differ
+ */
+void Lockstep_Locate(struct Lockstep *lockstep) {
+    struct Divergence *divergence = &lockstep->divergence;
+    uint64_t target = lockstep->instructions;
+
+    lockstep->referenceCPU = lockstep->checkpointCPU;
+    lockstep->candidateCPU = lockstep->checkpointCPU;
+    Lockstep_CopyRAM(lockstep->referenceRAM, lockstep->checkpointRAM);
+    Lockstep_CopyRAM(lockstep->candidateRAM, lockstep->checkpointRAM);
+
+    lockstep->diverged = 1;
+
+    int change = 0;
+
+    for (lockstep->instructions = lockstep->checkpointInstruction; lockstep->instructions < target;) {
+        while (change < lockstep->keypadLogLength && lockstep->keypadLog[change].instruction == lockstep->instructions) {
+            lockstep->referenceCPU.keypad = lockstep->keypadLog[change].keypad;
+            lockstep->candidateCPU.keypad = lockstep->keypadLog[change++].keypad;
+        }
+
+        uint16_t pc = lockstep->referenceCPU.pc;
+        uint16_t opcode = CPU_FetchOpCode(&lockstep->referenceCPU, lockstep->referenceRAM);
+
+        lockstep->reference(&lockstep->referenceCPU, lockstep->referenceRAM);
+        lockstep->candidate(&lockstep->candidateCPU, lockstep->candidateRAM);
+        lockstep->instructions++;
+
+        if (Lockstep_Diff(lockstep, divergence) > 0) {
+            divergence->instruction = lockstep->instructions - 1;
+            divergence->pc = pc;
+            divergence->opcode = opcode;
+            return;
+        }
+    }
+
+    // The candidate depends on something outside the compared state, e.g. a stale cache
+    divergence->instruction = target;
+    divergence->pc = lockstep->referenceCPU.pc;
+    divergence->opcode = CPU_FetchOpCode(&lockstep->referenceCPU, lockstep->referenceRAM);
+    divergence->differenceCount = 0;
+}
+
+struct Lockstep *createLockstep(struct CPU *cpu, struct RAM *ram, EngineStep reference, EngineStep candidate,
+                                int interval, enum LockstepMode mode) {
+    struct Lockstep *lockstep = (struct Lockstep *) malloc(sizeof(struct Lockstep));
+    memset(lockstep, 0, sizeof(struct Lockstep));
+
+    lockstep->reference = reference;
+    lockstep->candidate = candidate;
+    lockstep->interval = interval > 0 ? interval : 1;
+    lockstep->mode = mode;
+
+    lockstep->referenceRAM = (struct RAM *) malloc(sizeof(struct RAM));
+    lockstep->candidateRAM = (struct RAM *) malloc(sizeof(struct RAM));
+    lockstep->checkpointRAM = (struct RAM *) malloc(sizeof(struct RAM));
+
+    lockstep->referenceCPU = *cpu;
+    lockstep->candidateCPU = *cpu;
+
+    memcpy(lockstep->referenceRAM, ram, sizeof(struct RAM));
+    memcpy(lockstep->candidateRAM, ram, sizeof(struct RAM));
+    lockstep->referenceRAM->decoded = NULL;
+
+    lockstep->checkpointRAM->decoded = NULL;
+    Lockstep_Checkpoint(lockstep);
+
+    return lockstep;
+}
+
+int Lockstep_Check(struct Lockstep *lockstep) {
+    if (lockstep->diverged) return 1;
+    if (lockstep->instructions == lockstep->checkpointInstruction) return 0;
+
+    if (!Lockstep_Matches(lockstep)) {
+        Lockstep_Locate(lockstep);
+        return 1;
+    }
+
+    Lockstep_Checkpoint(lockstep);
+
+    return 0;
+}
+
+int Lockstep_SetKeypad(struct Lockstep *lockstep, uint16_t keypad) {
+    if (lockstep->diverged) return 1;
+    if (lockstep->referenceCPU.keypad == keypad) return 0;
+
+    struct KeypadChange *last = lockstep->keypadLogLength > 0 ? &lockstep->keypadLog[lockstep->keypadLogLength - 1] : NULL;
+
+    // Several changes before the same instruction collapse into one, so a full log always has progress to check
+    if (last != NULL && last->instruction == lockstep->instructions) {
+        last->keypad = keypad;
+    } else {
+        if (lockstep->keypadLogLength == LOCKSTEP_KEYPAD_LOG && Lockstep_Check(lockstep)) return 1;
+
+        struct KeypadChange *change = &lockstep->keypadLog[lockstep->keypadLogLength++];
+        change->instruction = lockstep->instructions;
+        change->keypad = keypad;
+    }
+
+    lockstep->referenceCPU.keypad = keypad;
+    lockstep->candidateCPU.keypad = keypad;
+
+    return 0;
+}
+
+int Lockstep_Run(struct Lockstep *lockstep, uint64_t count) {
+    if (lockstep->diverged) return 1;
+
+    uint64_t end = lockstep->instructions + count;
+
+    while (lockstep->instructions < end) {
+        uint64_t next = lockstep->checkpointInstruction + lockstep->interval;
+        if (next > end) next = end;
+
+        while (lockstep->instructions < next) {
+            lockstep->reference(&lockstep->referenceCPU, lockstep->referenceRAM);
+            lockstep->candidate(&lockstep->candidateCPU, lockstep->candidateRAM);
+            lockstep->instructions++;
+        }
+
+        if (lockstep->instructions - lockstep->checkpointInstruction == (uint64_t) lockstep->interval &&
+            Lockstep_Check(lockstep)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void Lockstep_Report(struct Lockstep *lockstep, FILE *stream) {
+    struct Divergence *divergence = &lockstep->divergence;
+    char disassembly[DISASSEMBLY_SIZE];
+
+    if (!lockstep->diverged) {
+        fprintf(stream, "No divergence in %llu instructions\n", (unsigned long long) lockstep->instructions);
+        return;
+    }
+
+    CPU_Disassemble(divergence->opcode, disassembly);
+
+    fprintf(stream, "Divergence at instruction %llu: PC 0x%03X opcode 0x%04X (%s)\n",
+            (unsigned long long) divergence->instruction, divergence->pc, divergence->opcode, disassembly);
+
+    if (divergence->differenceCount == 0) {
+        fprintf(stream, "  Not reproducible on replay from instruction %llu\n",
+                (unsigned long long) lockstep->checkpointInstruction);
+    }
+
+    for (int i = 0; i < divergence->differenceCount; i++) {
+        fprintf(stream, "  %s\n", divergence->differences[i]);
+    }
+}
+
+void Lockstep_Free(struct Lockstep *lockstep) {
+    free(lockstep->referenceRAM);
+    free(lockstep->candidateRAM);
+    free(lockstep->checkpointRAM);
+    free(lockstep);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file lockstep.h
+ *
+ * Differential lockstep checker between the reference interpreter and faster engines of the CHIP8 Emulator
+ */
+
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LOCKSTEP_MAX_DIFFERENCES 16
+#define LOCKSTEP_KEYPAD_LOG 256
+
+/**
+ * Executes one instruction, the reference engine is CPU_Step on a RAM without predecoded table, the candidate e.g. CPU_StepDecoded
+ */
+typedef void (*EngineStep)(struct CPU *cpu, struct RAM *ram);
+
+/**
+ * Full: Compares every field of struct CPU and struct RAM
+ * Hash: Compares a 64-bit hash of the same fields, for engines whose state is only available as a hash
+ */
+enum LockstepMode {
+    LOCKSTEP_FULL,
+    LOCKSTEP_HASH
+};
+
+struct KeypadChange {
+    uint64_t instruction;
+    uint16_t keypad;
+};
+
+struct Divergence {
+    // Instruction count and state right before the first instruction whose result differs
+    uint64_t instruction;
+    uint16_t pc;
+    uint16_t opcode;
+
+    char differences[LOCKSTEP_MAX_DIFFERENCES][64];
+    int differenceCount;
+};
+
+/**
+ * Both engines start from the same state and run with the same keypad. States are compared every interval
+ * instructions, on a mismatch the run is replayed from the last matching checkpoint one instruction at a time,
+ * with the keypad changes logged since then, to find the first diverging instruction.
+ */
+struct Lockstep {
+    EngineStep reference;
+    EngineStep candidate;
+
+    struct CPU referenceCPU;
+    struct RAM *referenceRAM;
+
+    struct CPU candidateCPU;
+    struct RAM *candidateRAM;
+
+    // Last state on which both engines agreed
+    struct CPU checkpointCPU;
+    struct RAM *checkpointRAM;
+    uint64_t checkpointInstruction;
+
+    struct KeypadChange keypadLog[LOCKSTEP_KEYPAD_LOG];
+    int keypadLogLength;
+
+    uint64_t instructions;
+    int interval;
+    enum LockstepMode mode;
+
+    int diverged;
+    struct Divergence divergence;
+};
+
+/**
+ * Copies cpu and ram as the initial state of both engines. The candidate RAM keeps the decoded table of ram,
+ * the reference RAM gets none.
+ */
+struct Lockstep *createLockstep(struct CPU *cpu, struct RAM *ram, EngineStep reference, EngineStep candidate,
+                                int interval, enum LockstepMode mode);
+
+/**
+ * Sets the keypad of both engines, a full keypad log forces a comparison and a new checkpoint
+ * @return 1 if the engines diverged
+ */
+int Lockstep_SetKeypad(struct Lockstep *lockstep, uint16_t keypad);
+
+/**
+ * Runs both engines for count instructions, comparing every interval instructions
+ * @return 1 if the engines diverged, see lockstep->divergence
+ */
+int Lockstep_Run(struct Lockstep *lockstep, uint64_t count);
+
+/**
+ * Compares both engines now, regardless of the interval
+ * @return 1 if the engines diverged
+ */
+int Lockstep_Check(struct Lockstep *lockstep);
+
+void Lockstep_Report(struct Lockstep *lockstep, FILE *stream);
+
+uint64_t Lockstep_HashState(struct CPU *cpu, struct RAM *ram);
+
+void Lockstep_Free(struct Lockstep *lockstep);
+
+#endif
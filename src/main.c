@@ -1,65 +1,191 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <time.h>
+#include <signal.h>
 
 #include "ram/ram.c"
 #include "cpu/cpu.c"
+#include "clock/clock.c"
+#include "latency/latency.c"
+#include "shm/shm.c"
+#include "cache/cache.c"
+#include "debugger/debugger.c"
 #include "window/window.c"
 
-void launchROMFile(const char *filename, uint8_t memory[MEMORY_SIZE]);
+// Microseconds between frames, 2.5 ms per instruction
+#define FRAME_DELAY (2500 * CYCLES_PER_FRAME)
+
+volatile sig_atomic_t interrupted = 0;
+
+void launchROMFile(const char *filename, struct RAM *ram);
+
+void interrupt(int code) {
+    (void) code;
+    interrupted = 1;
+}
 
 int main(int argc, char *args[]) {
-    srand(time(NULL));
+    const char *romFile = "chip8.ch8";
+    const char *shmName = NULL;
+    int shmForce = 0;
+    const char *cacheDirectory = NULL;
+    const char *debugSocket = NULL;
+    int debug = 0;
+    int headless = 0;
+    int runAhead = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(args[i], "--rom") == 0 && i + 1 < argc) {
+            romFile = args[++i];
+        } else if (strcmp(args[i], "--shm") == 0 && i + 1 < argc) {
+            shmName = args[++i];
+        } else if (strcmp(args[i], "--shm-force") == 0) {
+            shmForce = 1;
+        } else if (strcmp(args[i], "--cache") == 0 && i + 1 < argc) {
+            cacheDirectory = args[++i];
+        } else if (strcmp(args[i], "--run-ahead") == 0 && i + 1 < argc) {
+            runAhead = atoi(args[++i]);
+        } else if (strcmp(args[i], "--debug-socket") == 0 && i + 1 < argc) {
+            debugSocket = args[++i];
+        } else if (strcmp(args[i], "--debug") == 0) {
+            debug = 1;
+        } else if (strcmp(args[i], "--headless") == 0) {
+            headless = 1;
+        }
+    }
 
     struct CPU *cpu = createCPU();
     struct RAM *ram = createRAM();
 
-    struct EmulatorWindow *window = createWindow(argc, args);
+    cpu->seed = (uint32_t) time(NULL) | 1;
+
+    struct EmulatorWindow *window = headless ? NULL : createWindow(argc, args);
+
+    struct SharedMemory *shm = NULL;
+    if (shmName != NULL && (shm = createSharedMemory(shmName, shmForce)) == NULL) exit(0);
+
+    signal(SIGINT, interrupt);
+    signal(SIGTERM, interrupt);
+
+    launchROMFile(romFile, ram);
+
+    struct TranslationCache *cache = cacheDirectory != NULL ? Cache_Open(cacheDirectory, ram) : NULL;
+    void (*stepFrame)(struct CPU *cpu, struct RAM *ram) = cache != NULL ? CPU_StepFrameDecoded : CPU_StepFrame;
+
+    struct Debugger *debugger = NULL;
+    if (debug || debugSocket != NULL) {
+        debugger = createDebugger();
+
+        if (debugSocket == NULL) {
+            Debugger_ListenStdin(debugger);
+        } else if (Debugger_ListenSocket(debugger, debugSocket) < 0) {
+            printf("Debugger socket error: %s\n", debugSocket);
+            exit(0);
+        }
+    }
+
+    /**
+     * Run-ahead
+     * The machine is copied every frame and the copy runs runAhead frames further with the current keypad,
+     * its display is presented so the effect of an input shows up runAhead frames earlier.
+     * The real machine is never touched by the speculation, so nothing has to be restored.
+     * While the debugger is paused the real machine is presented, it is the state being inspected.
+     */
+    struct CPU speculativeCPU;
+    struct RAM *speculativeRAM = runAhead > 0 ? (struct RAM *) malloc(sizeof(struct RAM)) : NULL;
+    uint64_t emulationTime = 0;
+    uint64_t runAheadTime = 0;
+    struct RAM *lastPresented = ram;
+
+    uint64_t frame = 0;
+
+    while (!interrupted && (window == NULL || !window->quit)) {
+        if (window != NULL) Window_ListenEvents(window, cpu);
+        if (shm != NULL) Shm_ApplyInput(shm, cpu);
+
+        if (debugger != NULL) {
+            Debugger_Poll(debugger, cpu, ram);
+            if (debugger->quit) break;
+        }
+
+        uint64_t start = Clock_Now();
+
+        // The instrumented step only runs while breakpoints, watchpoints, conditions or stepping are active
+        if (debugger != NULL && Debugger_IsArmed(debugger)) {
+            Debugger_StepFrame(debugger, cpu, ram);
+        } else {
+            stepFrame(cpu, ram);
+        }
+        frame++;
+
+        struct RAM *presented = ram;
+
+        if (runAhead > 0 && (debugger == NULL || !debugger->paused)) {
+            uint64_t speculation = Clock_Now();
+
+            speculativeCPU = *cpu;
+            memcpy(speculativeRAM, ram, sizeof(struct RAM));
+
+            for (int i = 0; i < runAhead; i++) {
+                stepFrame(&speculativeCPU, speculativeRAM);
+            }
 
-    launchROMFile("chip8.ch8", ram->memory);
+            presented = speculativeRAM;
+            runAheadTime += Clock_Now() - speculation;
+        }
 
-    while (!window->quit) {
-        Window_ListenEvents(window, cpu);
+        emulationTime += Clock_Now() - start;
 
-        CPU_Step(cpu, ram);
+        if (shm != NULL) Shm_Publish(shm, cpu, ram, frame);
 
-        if (ram->drawFlag) {
-            Window_RenderDisplay(window, ram);
-            ram->drawFlag = 0;
+        // drawFlag of the copy also covers draws of the real frame, it was copied after them.
+        // Switching between the copy and the real machine redraws even without a draw
+        if (window != NULL && (presented->drawFlag || presented != lastPresented)) {
+            Window_RenderDisplay(window, presented);
+            lastPresented = presented;
         }
+        ram->drawFlag = 0;
 
-        usleep(2500);
+        usleep(FRAME_DELAY);
     }
 
-    Window_Close(window);
+    if (runAhead > 0 && frame > 0) {
+        double perFrame = (double) runAheadTime / (double) frame / 1e3;
+
+        printf("Run-ahead %d: %.1f us per frame (%.2f us per lookahead frame), %.1f%% of emulation time\n", runAhead,
+               perFrame, perFrame / runAhead, 100.0 * (double) runAheadTime / (double) emulationTime);
+    }
+
+    free(speculativeRAM);
+
+    if (window != NULL) {
+        Window_Close(window);
+        free(window);
+    }
+
+    if (shm != NULL) Shm_Close(shm);
+    if (cache != NULL) Cache_Close(cache, ram);
+    if (debugger != NULL) Debugger_Close(debugger);
 
     free(cpu);
     free(ram);
-    free(window);
 
     return 1;
 }
 
-void launchROMFile(const char *filename, uint8_t memory[MEMORY_SIZE]) {
-    char fileSource[10] = "../roms/";
-    strcat(fileSource, filename);
+/**
+ * Paths are used as given, a bare file name that is not in the working directory is looked up in ../roms/
+ */
+void launchROMFile(const char *filename, struct RAM *ram) {
+    char fileSource[256] = "../roms/";
+    int bare = strchr(filename, '/') == NULL && strchr(filename, '\\') == NULL;
+
+    if (RAM_LoadROM(ram, filename) >= 0) return;
 
-    FILE *file = fopen(fileSource, "rb");
+    strncat(fileSource, filename, sizeof(fileSource) - strlen(fileSource) - 1);
 
-    if (file == NULL) {
+    if (!bare || RAM_LoadROM(ram, fileSource) < 0) {
         printf("File not found");
         exit(0);
     }
-
-    int counter = 0;
-    uint8_t byte;
-
-    while (fread(&byte, 1, 1, file) > 0) {
-        memory[ROM_ALLOCATION + counter] = byte;
-
-        counter++;
-    }
-
-    fclose(file);
-
 }
@@ -0,0 +1,131 @@
+#include "pool.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+uint8_t *Pool_AllocateSlab(enum SlabBacking *backing) {
+    void *memory = NULL;
+
+#ifdef MAP_HUGETLB
+    memory = mmap(NULL, POOL_SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (memory != MAP_FAILED) {
+        *backing = SLAB_HUGETLB;
+        return (uint8_t *) memory;
+    }
+#endif
+
+#ifdef _WIN32
+    memory = _aligned_malloc(POOL_SLAB_SIZE, POOL_SLAB_SIZE);
+    *backing = SLAB_PLAIN;
+#else
+    if (posix_memalign(&memory, POOL_SLAB_SIZE, POOL_SLAB_SIZE) != 0) return NULL;
+
+    *backing = SLAB_PLAIN;
+
+#ifdef MADV_HUGEPAGE
+    if (madvise(memory, POOL_SLAB_SIZE, MADV_HUGEPAGE) == 0) *backing = SLAB_TRANSPARENT;
+#endif
+#endif
+
+    return (uint8_t *) memory;
+}
+
+void Pool_FreeSlab(struct Slab *slab) {
+#ifdef _WIN32
+    _aligned_free(slab->memory);
+#else
+    if (slab->backing == SLAB_HUGETLB) {
+        munmap(slab->memory, POOL_SLAB_SIZE);
+    } else {
+        free(slab->memory);
+    }
+#endif
+}
+
+struct InstancePool *createInstancePool() {
+    struct InstancePool *pool = (struct InstancePool *) malloc(sizeof(struct InstancePool));
+    memset(pool, 0, sizeof(struct InstancePool));
+
+    pool->stride = (sizeof(struct Instance) + POOL_ALIGNMENT - 1) & ~((size_t) POOL_ALIGNMENT - 1);
+    pool->instancesPerSlab = (int) (POOL_SLAB_SIZE / pool->stride);
+
+    CPU_Init(&pool->template.cpu);
+    RAM_Init(&pool->template.ram);
+
+    return pool;
+}
+
+void Pool_SetTemplate(struct InstancePool *pool, struct CPU *cpu, struct RAM *ram) {
+    pool->template.cpu = *cpu;
+    memcpy(&pool->template.ram, ram, sizeof(struct RAM));
+}
+
+struct Instance *Pool_Acquire(struct InstancePool *pool) {
+    struct Instance *instance = pool->freeList;
+
+    if (instance != NULL) {
+        pool->freeList = *(struct Instance **) instance;
+    } else {
+        if (pool->slabCount == 0 || pool->slabCursor == pool->instancesPerSlab) {
+            if (pool->slabCount == pool->slabCapacity) {
+                int capacity = pool->slabCapacity > 0 ? pool->slabCapacity * 2 : 16;
+                struct Slab *slabs = (struct Slab *) realloc(pool->slabs, sizeof(struct Slab) * capacity);
+
+                // The pool keeps its slabs when the list can not grow
+                if (slabs == NULL) return NULL;
+
+                pool->slabs = slabs;
+                pool->slabCapacity = capacity;
+            }
+
+            struct Slab *slab = &pool->slabs[pool->slabCount];
+            if ((slab->memory = Pool_AllocateSlab(&slab->backing)) == NULL) return NULL;
+
+            pool->slabCount++;
+            pool->slabCursor = 0;
+        }
+
+        instance = (struct Instance *) (pool->slabs[pool->slabCount - 1].memory + pool->stride * pool->slabCursor++);
+    }
+
+    pool->instanceCount++;
+
+    memcpy(instance, &pool->template, sizeof(struct Instance));
+
+    return instance;
+}
+
+void Pool_Reset(struct InstancePool *pool, struct Instance *instance) {
+    memcpy(instance, &pool->template, sizeof(struct Instance));
+}
+
+void Pool_Release(struct InstancePool *pool, struct Instance *instance) {
+    *(struct Instance **) instance = pool->freeList;
+    pool->freeList = instance;
+    pool->instanceCount--;
+}
+
+size_t Pool_BytesPerInstance(struct InstancePool *pool) {
+    return POOL_SLAB_SIZE / pool->instancesPerSlab;
+}
+
+int Pool_HugeSlabCount(struct InstancePool *pool) {
+    int count = 0;
+
+    for (int i = 0; i < pool->slabCount; i++) {
+        if (pool->slabs[i].backing != SLAB_PLAIN) count++;
+    }
+
+    return count;
+}
+
+void Pool_Free(struct InstancePool *pool) {
+    for (int i = 0; i < pool->slabCount; i++) {
+        Pool_FreeSlab(&pool->slabs[i]);
+    }
+
+    free(pool->slabs);
+    free(pool);
+}
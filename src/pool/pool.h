@@ -0,0 +1,96 @@
+/**
+ * @file pool.h
+ *
+ * Instance pool of the CHIP8 Emulator, for hosting many machines at once
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define POOL_ALIGNMENT 64
+#define POOL_SLAB_SIZE (2 * 1024 * 1024)
+
+/**
+ * CPU and RAM of one machine in a single block, the CPU fills the first cache line and memory starts on the next
+ */
+struct Instance {
+    struct CPU cpu;
+    struct RAM ram;
+};
+
+/**
+ * Hugetlb: Slab mapped from the hugetlbfs pool
+ * Transparent: Slab aligned to a huge page and advised for transparent huge pages
+ * Plain: Slab of regular pages
+ */
+enum SlabBacking {
+    SLAB_HUGETLB,
+    SLAB_TRANSPARENT,
+    SLAB_PLAIN
+};
+
+struct Slab {
+    uint8_t *memory;
+    enum SlabBacking backing;
+};
+
+/**
+ * Instances are carved from POOL_SLAB_SIZE slabs with a stride rounded up to POOL_ALIGNMENT, so no two instances
+ * share a cache line. Released instances are kept on a free list threaded through their own memory.
+ */
+struct InstancePool {
+    struct Slab *slabs;
+    int slabCount;
+    int slabCapacity;
+
+    size_t stride;
+    int instancesPerSlab;
+
+    // Next unused instance of the last slab
+    int slabCursor;
+
+    struct Instance *freeList;
+    int instanceCount;
+
+    // Copied into every acquired or reset instance
+    struct Instance template;
+};
+
+/**
+ * The template starts as a machine from CPU_Init and RAM_Init
+ */
+struct InstancePool *createInstancePool();
+
+/**
+ * Replaces the template, e.g. with a machine that has a ROM loaded. ram->decoded is copied as is,
+ * instances stepped on different threads need their own table.
+ */
+void Pool_SetTemplate(struct InstancePool *pool, struct CPU *cpu, struct RAM *ram);
+
+/**
+ * @return Instance initialized from the template, NULL if no slab can be allocated
+ */
+struct Instance *Pool_Acquire(struct InstancePool *pool);
+
+void Pool_Reset(struct InstancePool *pool, struct Instance *instance);
+
+void Pool_Release(struct InstancePool *pool, struct Instance *instance);
+
+/**
+ * @return Bytes of slab memory per instance, including the unused tail of each slab
+ */
+size_t Pool_BytesPerInstance(struct InstancePool *pool);
+
+/**
+ * @return Number of slabs mapped from hugetlbfs or advised for transparent huge pages
+ */
+int Pool_HugeSlabCount(struct InstancePool *pool);
+
+void Pool_Free(struct InstancePool *pool);
+
+#endif
@@ -0,0 +1,111 @@
+#include "profiler.h"
+
+struct Profiler *createProfiler() {
+    struct Profiler *profiler = (struct Profiler *) malloc(sizeof(struct Profiler));
+
+    memset(profiler->table, 0, sizeof(profiler->table));
+
+    // Root node stands for the code reached from the ROM entry point without any CALL
+    profiler->nodes[0].parent = -1;
+    profiler->nodes[0].entry = ROM_ALLOCATION;
+    profiler->nodes[0].instructions = 0;
+    profiler->nodes[0].nanoseconds = 0;
+    profiler->nodeCount = 1;
+
+    profiler->current = 0;
+    profiler->depth = 0;
+    profiler->overflow = 0;
+    profiler->instructionCount = 0;
+    profiler->lastSample = Clock_Now();
+
+    return profiler;
+}
+
+int Profiler_FindChild(struct Profiler *profiler, int parent, uint16_t entry) {
+    uint32_t slot = ((uint32_t) parent * 4099u + entry) & (PROFILER_TABLE_SIZE - 1);
+
+    while (profiler->table[slot] != 0) {
+        int index = profiler->table[slot] - 1;
+
+        if (profiler->nodes[index].parent == parent && profiler->nodes[index].entry == entry) return index;
+
+        slot = (slot + 1) & (PROFILER_TABLE_SIZE - 1);
+    }
+
+    // Too many distinct stacks, keep attributing to the caller
+    if (profiler->nodeCount == PROFILER_MAX_NODES) return parent;
+
+    int index = profiler->nodeCount++;
+
+    profiler->nodes[index].parent = parent;
+    profiler->nodes[index].entry = entry;
+    profiler->nodes[index].instructions = 0;
+    profiler->nodes[index].nanoseconds = 0;
+    profiler->table[slot] = index + 1;
+
+    return index;
+}
+
+void Profiler_Step(struct Profiler *profiler, struct CPU *cpu, struct RAM *ram) {
+    uint16_t opcode = CPU_FetchOpCode(cpu, ram);
+    struct CallNode *node = &profiler->nodes[profiler->current];
+
+    node->instructions++;
+
+    if ((++profiler->instructionCount & (PROFILER_TIME_INTERVAL - 1)) == 0) {
+        uint64_t now = Clock_Now();
+        node->nanoseconds += now - profiler->lastSample;
+        profiler->lastSample = now;
+    }
+
+    CPU_Step(cpu, ram);
+
+    if ((opcode & 0xF000) == 0x2000) {
+        if (profiler->depth < STACK_SIZE) {
+            profiler->stack[profiler->depth++] = profiler->current;
+            profiler->current = Profiler_FindChild(profiler, profiler->current, opcode & 0x0FFF);
+        } else {
+            profiler->overflow++;
+        }
+    } else if ((opcode & 0xF0FF) == 0x00EE) {
+        if (profiler->overflow > 0) {
+            profiler->overflow--;
+        } else if (profiler->depth > 0) {
+            profiler->current = profiler->stack[--profiler->depth];
+        }
+    }
+}
+
+void Profiler_StepFrame(struct Profiler *profiler, struct CPU *cpu, struct RAM *ram) {
+    for (int i = 0; i < CYCLES_PER_FRAME; i++) {
+        Profiler_Step(profiler, cpu, ram);
+    }
+}
+
+void Profiler_WriteFolded(struct Profiler *profiler, struct RAM *ram, FILE *stream, enum ProfilerWeight weight) {
+    int path[STACK_SIZE + 1];
+
+    for (int i = 0; i < profiler->nodeCount; i++) {
+        struct CallNode *node = &profiler->nodes[i];
+        uint64_t value = weight == PROFILER_INSTRUCTIONS ? node->instructions : node->nanoseconds;
+
+        if (value == 0) continue;
+
+        int depth = 0;
+        for (int index = i; index >= 0 && depth <= STACK_SIZE; index = profiler->nodes[index].parent) {
+            path[depth++] = index;
+        }
+
+        for (int d = depth - 1; d >= 0; d--) {
+            uint16_t entry = profiler->nodes[path[d]].entry;
+            uint16_t opcode = (ram->memory[entry & 0xFFF] << 8) | ram->memory[(entry + 1) & 0xFFF];
+            char disassembly[DISASSEMBLY_SIZE];
+
+            CPU_Disassemble(opcode, disassembly);
+
+            fprintf(stream, "%s_%03X %s%s", path[d] == 0 ? "main" : "sub", entry, disassembly, d > 0 ? ";" : "");
+        }
+
+        fprintf(stream, " %llu\n", (unsigned long long) value);
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file profiler.h
+ *
+ * Call-graph profiler of ROMs running on the CHIP8 Emulator
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define PROFILER_MAX_NODES 4096
+#define PROFILER_TABLE_SIZE (PROFILER_MAX_NODES * 2)
+
+// Host time is sampled once every PROFILER_TIME_INTERVAL instructions, must be a power of two
+#define PROFILER_TIME_INTERVAL 64
+
+enum ProfilerWeight {
+    PROFILER_INSTRUCTIONS,
+    PROFILER_NANOSECONDS
+};
+
+/**
+ * One distinct call stack, a path of subroutine entry points from the ROM entry
+ * Instructions are counted exactly, nanoseconds are sampled
+ */
+struct CallNode {
+    int parent;
+    uint16_t entry;
+
+    uint64_t instructions;
+    uint64_t nanoseconds;
+};
+
+struct Profiler {
+    struct CallNode nodes[PROFILER_MAX_NODES];
+    int nodeCount;
+
+    // Open addressing table from (parent, entry) to the child node index + 1
+    int table[PROFILER_TABLE_SIZE];
+
+    // Node of the running code and the nodes of its callers
+    int current;
+    int stack[STACK_SIZE];
+    int depth;
+    // Calls beyond STACK_SIZE, attributed to the deepest node until their returns are matched
+    int overflow;
+
+    uint64_t instructionCount;
+    uint64_t lastSample;
+};
+
+struct Profiler *createProfiler();
+
+/**
+ * Executes one instruction with CPU_Step and attributes it to the current call stack
+ * CALL pushes the target as a new stack frame and RET pops it
+ */
+void Profiler_Step(struct Profiler *profiler, struct CPU *cpu, struct RAM *ram);
+
+void Profiler_StepFrame(struct Profiler *profiler, struct CPU *cpu, struct RAM *ram);
+
+/**
+ * Writes one "frame;frame;frame weight" line per call stack for flame graph tools
+ * Frames are named by entry address and the disassembly of the instruction there, e.g. "sub_2A4 LD V0, 0x05"
+ */
+void Profiler_WriteFolded(struct Profiler *profiler, struct RAM *ram, FILE *stream, enum ProfilerWeight weight);
+
+#endif
@@ -3,12 +3,19 @@
 struct RAM *createRAM() {
     struct RAM *ram = (struct RAM *) malloc(sizeof(struct RAM));
 
+    RAM_Init(ram);
+
+    return ram;
+}
+
+void RAM_Init(struct RAM *ram) {
     memset(ram->memory, 0, sizeof(uint8_t) * MEMORY_SIZE);
     memset(ram->display, 0, sizeof(uint8_t) * DISPLAY_SIZE);
 
-    writeFontset(ram->memory);
+    ram->drawFlag = 0;
+    ram->decoded = NULL;
 
-    return ram;
+    writeFontset(ram->memory);
 }
 
 void writeFontset(uint8_t memory[MEMORY_SIZE]) {
@@ -34,4 +41,31 @@ void writeFontset(uint8_t memory[MEMORY_SIZE]) {
     for (int i = 0; i < FONTSET_SIZE; i++) {
         memory[FONTSET_ALLOCATION + i] = fontset[i];
     }
+}
+
+int RAM_LoadROM(struct RAM *ram, const char *path) {
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL) return -1;
+
+    int size = (int) fread(ram->memory + ROM_ALLOCATION, 1, MEMORY_SIZE - ROM_ALLOCATION, file);
+
+    fclose(file);
+
+    return size;
+}
+
+uint64_t RAM_Hash(const uint8_t *bytes, size_t length, uint64_t seed) {
+    uint64_t hash = seed;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+uint64_t RAM_HashDisplay(struct RAM *ram) {
+    return RAM_Hash(ram->display, DISPLAY_SIZE, HASH_SEED);
 }
\ No newline at end of file
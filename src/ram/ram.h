@@ -11,24 +11,57 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 #define MEMORY_SIZE 4096
+#define MEMORY_MASK (MEMORY_SIZE - 1)
 #define DISPLAY_SIZE (64 * 32)
+#define DISPLAY_MASK (DISPLAY_SIZE - 1)
 
 #define FONTSET_SIZE 80
 #define FONTSET_ALLOCATION 0x00
 #define ROM_ALLOCATION 0x200
 
+// Offset basis of FNV-1a, the seed of a new hash
+#define HASH_SEED 0xCBF29CE484222325ULL
+
 struct RAM {
     uint8_t memory[MEMORY_SIZE];
 
     uint8_t display[DISPLAY_SIZE];
 
     int drawFlag;
+
+    /**
+     * Predecoded Instructions
+     * Optional table of MEMORY_SIZE entries used by CPU_StepDecoded instead of decoding every opcode, see predecode.h
+     */
+    struct DecodedOp *decoded;
 };
 
 struct RAM *createRAM();
 
+/**
+ * Initializes a RAM in place, for machines not allocated by createRAM
+ */
+void RAM_Init(struct RAM *ram);
+
 void writeFontset(uint8_t memory[MEMORY_SIZE]);
 
+/**
+ * Copies the ROM at path into memory starting from ROM_ALLOCATION
+ * @return Size of the ROM in bytes, or -1 if the file can not be read
+ */
+int RAM_LoadROM(struct RAM *ram, const char *path);
+
+/**
+ * 64-bit FNV-1a hash of length bytes, continuing from seed so several blocks can be hashed as one
+ */
+uint64_t RAM_Hash(const uint8_t *bytes, size_t length, uint64_t seed);
+
+/**
+ * Hash of the display, used to compare frames without storing them
+ */
+uint64_t RAM_HashDisplay(struct RAM *ram);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "script.h"
+
+struct InputScript *Script_Load(const char *path) {
+    FILE *file = fopen(path, "r");
+
+    if (file == NULL) return NULL;
+
+    struct InputScript *script = (struct InputScript *) malloc(sizeof(struct InputScript));
+    int capacity = 16;
+
+    script->events = (struct InputEvent *) malloc(sizeof(struct InputEvent) * capacity);
+    script->length = 0;
+
+    char line[128];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        unsigned long frame;
+        unsigned int keys;
+
+        if (line[0] == '#' || sscanf(line, "%lu %x", &frame, &keys) != 2) continue;
+
+        if (script->length == capacity) {
+            capacity *= 2;
+            script->events = (struct InputEvent *) realloc(script->events, sizeof(struct InputEvent) * capacity);
+        }
+
+        script->events[script->length].frame = (uint32_t) frame;
+        script->events[script->length].keys = (uint16_t) keys;
+        script->length++;
+    }
+
+    fclose(file);
+
+    return script;
+}
+
+uint16_t Script_KeysAt(const struct InputScript *script, uint32_t frame, int *cursor) {
+    if (script == NULL) return 0;
+
+    while (*cursor < script->length && script->events[*cursor].frame <= frame) {
+        *cursor += 1;
+    }
+
+    return *cursor > 0 ? script->events[*cursor - 1].keys : 0;
+}
+
+void Script_Free(struct InputScript *script) {
+    if (script == NULL) return;
+
+    free(script->events);
+    free(script);
+}
@@ -0,0 +1,42 @@
+/**
+ * @file script.h
+ *
+ * Scripted keypad input for headless runs of the CHIP8 Emulator
+ */
+
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * Keypad state held from the given frame until the next event
+ * Bit i of keys is set while key i is pressed
+ */
+struct InputEvent {
+    uint32_t frame;
+    uint16_t keys;
+};
+
+/**
+ * Script file format, one event per line in ascending frame order:
+ *   <frame> <keys as hex mask>
+ * Lines starting with '#' are comments.
+ */
+struct InputScript {
+    struct InputEvent *events;
+    int length;
+};
+
+struct InputScript *Script_Load(const char *path);
+
+/**
+ * Keypad state at frame, cursor keeps the position between calls for increasing frames
+ */
+uint16_t Script_KeysAt(const struct InputScript *script, uint32_t frame, int *cursor);
+
+void Script_Free(struct InputScript *script);
+
+#endif
@@ -0,0 +1,217 @@
+#include "search.h"
+
+struct RAMSearch *createRAMSearch(struct RAM *ram) {
+    struct RAMSearch *search = (struct RAMSearch *) malloc(sizeof(struct RAMSearch));
+
+    search->freezeCount = 0;
+    Search_Reset(search, ram);
+
+    return search;
+}
+
+void Search_Reset(struct RAMSearch *search, struct RAM *ram) {
+    memset(search->candidates, 0xFF, sizeof(uint8_t) * MEMORY_SIZE);
+    search->candidateCount = MEMORY_SIZE;
+
+    Search_Snapshot(search, ram);
+}
+
+void Search_Snapshot(struct RAMSearch *search, struct RAM *ram) {
+    memcpy(search->snapshot, ram->memory, sizeof(uint8_t) * MEMORY_SIZE);
+}
+
+int Search_Match(uint8_t memory, uint8_t snapshot, struct SearchFilter filter) {
+    switch (filter.predicate) {
+        case SEARCH_EQUAL: return memory == filter.value;
+        case SEARCH_NOT_EQUAL: return memory != filter.value;
+        case SEARCH_CHANGED: return memory != snapshot;
+        case SEARCH_UNCHANGED: return memory == snapshot;
+        case SEARCH_INCREASED: return memory == (uint8_t) (snapshot + filter.value);
+        case SEARCH_DECREASED: return memory == (uint8_t) (snapshot - filter.value);
+        case SEARCH_RANGE: return memory >= filter.value && memory <= filter.high;
+        default: return 0;
+    }
+}
+
+#if defined(__AVX2__)
+
+__m256i Search_MatchAVX2(__m256i memory, __m256i snapshot, struct SearchFilter filter) {
+    __m256i value = _mm256_set1_epi8((char) filter.value);
+    __m256i ones = _mm256_set1_epi8((char) 0xFF);
+
+    switch (filter.predicate) {
+        case SEARCH_EQUAL: return _mm256_cmpeq_epi8(memory, value);
+        case SEARCH_NOT_EQUAL: return _mm256_xor_si256(_mm256_cmpeq_epi8(memory, value), ones);
+        case SEARCH_CHANGED: return _mm256_xor_si256(_mm256_cmpeq_epi8(memory, snapshot), ones);
+        case SEARCH_UNCHANGED: return _mm256_cmpeq_epi8(memory, snapshot);
+        case SEARCH_INCREASED: return _mm256_cmpeq_epi8(memory, _mm256_add_epi8(snapshot, value));
+        case SEARCH_DECREASED: return _mm256_cmpeq_epi8(memory, _mm256_sub_epi8(snapshot, value));
+        case SEARCH_RANGE: {
+            // Unsigned value <= memory <= high, there are no unsigned byte compares
+            __m256i high = _mm256_set1_epi8((char) filter.high);
+            return _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(memory, value), memory),
+                                    _mm256_cmpeq_epi8(_mm256_min_epu8(memory, high), memory));
+        }
+        default: return _mm256_setzero_si256();
+    }
+}
+
+#elif defined(__SSE2__)
+
+__m128i Search_MatchSSE2(__m128i memory, __m128i snapshot, struct SearchFilter filter) {
+    __m128i value = _mm_set1_epi8((char) filter.value);
+    __m128i ones = _mm_set1_epi8((char) 0xFF);
+
+    switch (filter.predicate) {
+        case SEARCH_EQUAL: return _mm_cmpeq_epi8(memory, value);
+        case SEARCH_NOT_EQUAL: return _mm_xor_si128(_mm_cmpeq_epi8(memory, value), ones);
+        case SEARCH_CHANGED: return _mm_xor_si128(_mm_cmpeq_epi8(memory, snapshot), ones);
+        case SEARCH_UNCHANGED: return _mm_cmpeq_epi8(memory, snapshot);
+        case SEARCH_INCREASED: return _mm_cmpeq_epi8(memory, _mm_add_epi8(snapshot, value));
+        case SEARCH_DECREASED: return _mm_cmpeq_epi8(memory, _mm_sub_epi8(snapshot, value));
+        case SEARCH_RANGE: {
+            // Unsigned value <= memory <= high, there are no unsigned byte compares
+            __m128i high = _mm_set1_epi8((char) filter.high);
+            return _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(memory, value), memory),
+                                 _mm_cmpeq_epi8(_mm_min_epu8(memory, high), memory));
+        }
+        default: return _mm_setzero_si128();
+    }
+}
+
+#endif
+
+int Search_Filter(struct RAMSearch *search, struct RAM *ram, struct SearchFilter filter) {
+    int count = 0;
+    int i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 32 <= MEMORY_SIZE; i += 32) {
+        __m256i memory = _mm256_loadu_si256((const __m256i *) (ram->memory + i));
+        __m256i snapshot = _mm256_loadu_si256((const __m256i *) (search->snapshot + i));
+        __m256i candidates = _mm256_loadu_si256((const __m256i *) (search->candidates + i));
+
+        candidates = _mm256_and_si256(candidates, Search_MatchAVX2(memory, snapshot, filter));
+
+        _mm256_storeu_si256((__m256i *) (search->candidates + i), candidates);
+        _mm256_storeu_si256((__m256i *) (search->snapshot + i), memory);
+
+        count += __builtin_popcount((unsigned int) _mm256_movemask_epi8(candidates));
+    }
+#elif defined(__SSE2__)
+    for (; i + 16 <= MEMORY_SIZE; i += 16) {
+        __m128i memory = _mm_loadu_si128((const __m128i *) (ram->memory + i));
+        __m128i snapshot = _mm_loadu_si128((const __m128i *) (search->snapshot + i));
+        __m128i candidates = _mm_loadu_si128((const __m128i *) (search->candidates + i));
+
+        candidates = _mm_and_si128(candidates, Search_MatchSSE2(memory, snapshot, filter));
+
+        _mm_storeu_si128((__m128i *) (search->candidates + i), candidates);
+        _mm_storeu_si128((__m128i *) (search->snapshot + i), memory);
+
+        count += __builtin_popcount((unsigned int) _mm_movemask_epi8(candidates));
+    }
+#endif
+
+    for (; i < MEMORY_SIZE; i++) {
+        uint8_t memory = ram->memory[i];
+
+        if (!Search_Match(memory, search->snapshot[i], filter)) search->candidates[i] = 0x00;
+        search->snapshot[i] = memory;
+
+        count += search->candidates[i] != 0;
+    }
+
+    search->candidateCount = count;
+
+    return count;
+}
+
+struct SearchBatch {
+    struct RAMSearch **searches;
+    struct RAM **rams;
+    int begin;
+    int end;
+    struct SearchFilter filter;
+};
+
+void *Search_RunBatch(void *argument) {
+    struct SearchBatch *batch = (struct SearchBatch *) argument;
+
+    for (int i = batch->begin; i < batch->end; i++) {
+        Search_Filter(batch->searches[i], batch->rams[i], batch->filter);
+    }
+
+    return NULL;
+}
+
+void Search_FilterBatch(struct RAMSearch **searches, struct RAM **rams, int count, struct SearchFilter filter,
+                        int threads) {
+    if (threads > count) threads = count;
+
+    if (threads <= 1) {
+        for (int i = 0; i < count; i++) Search_Filter(searches[i], rams[i], filter);
+        return;
+    }
+
+    pthread_t workers[threads];
+    struct SearchBatch batches[threads];
+
+    for (int t = 0; t < threads; t++) {
+        batches[t].searches = searches;
+        batches[t].rams = rams;
+        batches[t].begin = count * t / threads;
+        batches[t].end = count * (t + 1) / threads;
+        batches[t].filter = filter;
+
+        pthread_create(&workers[t], NULL, Search_RunBatch, &batches[t]);
+    }
+
+    for (int t = 0; t < threads; t++) pthread_join(workers[t], NULL);
+}
+
+int Search_Candidates(struct RAMSearch *search, uint16_t *addresses, int max) {
+    int count = 0;
+
+    for (int i = 0; i < MEMORY_SIZE && count < max; i++) {
+        if (search->candidates[i] != 0) addresses[count++] = (uint16_t) i;
+    }
+
+    return count;
+}
+
+int Search_Freeze(struct RAMSearch *search, uint16_t address, uint8_t value) {
+    address &= MEMORY_MASK;
+
+    for (int i = 0; i < search->freezeCount; i++) {
+        if (search->freezes[i].address == address) {
+            search->freezes[i].value = value;
+            return 0;
+        }
+    }
+
+    if (search->freezeCount == SEARCH_MAX_FREEZES) return -1;
+
+    search->freezes[search->freezeCount].address = address;
+    search->freezes[search->freezeCount].value = value;
+    search->freezeCount++;
+
+    return 0;
+}
+
+void Search_Unfreeze(struct RAMSearch *search, uint16_t address) {
+    address &= MEMORY_MASK;
+
+    for (int i = 0; i < search->freezeCount; i++) {
+        if (search->freezes[i].address == address) {
+            search->freezes[i] = search->freezes[--search->freezeCount];
+            return;
+        }
+    }
+}
+
+void Search_ApplyFreezes(struct RAMSearch *search, struct RAM *ram) {
+    for (int i = 0; i < search->freezeCount; i++) {
+        ram->memory[search->freezes[i].address] = search->freezes[i].value;
+    }
+}
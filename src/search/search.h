@@ -0,0 +1,101 @@
+/**
+ * @file search.h
+ *
+ * RAM search of the CHIP8 Emulator, narrows down the addresses of scores, lives and positions
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define SEARCH_MAX_FREEZES 32
+
+/**
+ * Equal, NotEqual: memory == value, memory != value
+ * Changed, Unchanged: memory compared to the snapshot of the previous filter
+ * Increased, Decreased: memory == snapshot + value, memory == snapshot - value (wrapping)
+ * Range: value <= memory <= high
+ */
+enum SearchPredicate {
+    SEARCH_EQUAL,
+    SEARCH_NOT_EQUAL,
+    SEARCH_CHANGED,
+    SEARCH_UNCHANGED,
+    SEARCH_INCREASED,
+    SEARCH_DECREASED,
+    SEARCH_RANGE
+};
+
+struct SearchFilter {
+    enum SearchPredicate predicate;
+    uint8_t value;
+    uint8_t high;
+};
+
+struct Freeze {
+    uint16_t address;
+    uint8_t value;
+};
+
+struct RAMSearch {
+    /**
+     * Candidates
+     * 0xFF for addresses still matching every filter, 0x00 for eliminated ones
+     */
+    uint8_t candidates[MEMORY_SIZE];
+    int candidateCount;
+
+    // Memory at the previous filter or snapshot
+    uint8_t snapshot[MEMORY_SIZE];
+
+    struct Freeze freezes[SEARCH_MAX_FREEZES];
+    int freezeCount;
+};
+
+struct RAMSearch *createRAMSearch(struct RAM *ram);
+
+/**
+ * Makes every address a candidate again and takes a new snapshot
+ */
+void Search_Reset(struct RAMSearch *search, struct RAM *ram);
+
+void Search_Snapshot(struct RAMSearch *search, struct RAM *ram);
+
+/**
+ * Eliminates candidates not matching filter, then takes a new snapshot
+ * @return Number of remaining candidates
+ */
+int Search_Filter(struct RAMSearch *search, struct RAM *ram, struct SearchFilter filter);
+
+/**
+ * Applies the same filter to count searches on up to threads threads, searches[i] against rams[i]
+ */
+void Search_FilterBatch(struct RAMSearch **searches, struct RAM **rams, int count, struct SearchFilter filter,
+                        int threads);
+
+/**
+ * Writes up to max candidate addresses in ascending order
+ * @return Number of addresses written
+ */
+int Search_Candidates(struct RAMSearch *search, uint16_t *addresses, int max);
+
+/**
+ * Pins memory[address] to value, Search_ApplyFreezes writes it back after every frame
+ * @return -1 when SEARCH_MAX_FREEZES addresses are already frozen
+ */
+int Search_Freeze(struct RAMSearch *search, uint16_t address, uint8_t value);
+
+void Search_Unfreeze(struct RAMSearch *search, uint16_t address);
+
+void Search_ApplyFreezes(struct RAMSearch *search, struct RAM *ram);
+
+#endif
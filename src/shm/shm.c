@@ -0,0 +1,135 @@
+#include "shm.h"
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct SharedMemory *mapSharedMemory(const char *name, int owner, int force) {
+    // POSIX names are a single path component
+    if (strchr(name, '/') != NULL) {
+        printf("Shared memory name must not contain '/': %s\n", name);
+        return NULL;
+    }
+
+    struct SharedMemory *shm = (struct SharedMemory *) malloc(sizeof(struct SharedMemory));
+
+    snprintf(shm->name, SHM_NAME_SIZE, "/chip8-%s", name);
+
+    if (owner && force) shm_unlink(shm->name);
+
+    int descriptor = shm_open(shm->name, owner ? O_CREAT | O_EXCL | O_RDWR : O_RDWR, 0600);
+
+    if (owner && descriptor < 0 && errno == EEXIST) {
+        printf("Shared memory segment in use: %s, --shm-force replaces a stale one\n", shm->name);
+        free(shm);
+        return NULL;
+    }
+
+    if (descriptor < 0 || (owner && ftruncate(descriptor, sizeof(struct SharedFrame)) < 0)) {
+        printf("Shared memory error: %s\n", shm->name);
+        if (descriptor >= 0) close(descriptor);
+        free(shm);
+        return NULL;
+    }
+
+    void *address = mmap(NULL, sizeof(struct SharedFrame), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if (address == MAP_FAILED) {
+        printf("Shared memory error: %s\n", shm->name);
+        free(shm);
+        return NULL;
+    }
+
+    shm->frame = (struct SharedFrame *) address;
+    shm->injected = 0;
+    shm->owner = owner;
+
+    if (owner) {
+        memset(shm->frame, 0, sizeof(struct SharedFrame));
+        shm->frame->version = SHM_VERSION;
+        __atomic_store_n(&shm->frame->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+    } else if (__atomic_load_n(&shm->frame->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+               shm->frame->version != SHM_VERSION) {
+        printf("Shared memory error: %s is not a CHIP8 segment of version %d\n", shm->name, SHM_VERSION);
+        Shm_Close(shm);
+        return NULL;
+    }
+
+    return shm;
+}
+
+struct SharedMemory *createSharedMemory(const char *name, int force) {
+    return mapSharedMemory(name, 1, force);
+}
+
+struct SharedMemory *Shm_Attach(const char *name) {
+    return mapSharedMemory(name, 0, 0);
+}
+
+void Shm_Close(struct SharedMemory *shm) {
+    munmap(shm->frame, sizeof(struct SharedFrame));
+
+    if (shm->owner) shm_unlink(shm->name);
+
+    free(shm);
+}
+
+#else
+
+struct SharedMemory *createSharedMemory(const char *name, int force) {
+    printf("Shared memory export is not supported on this platform\n");
+    return NULL;
+}
+
+struct SharedMemory *Shm_Attach(const char *name) {
+    return createSharedMemory(name, 0);
+}
+
+void Shm_Close(struct SharedMemory *shm) {
+    free(shm);
+}
+
+#endif
+
+void Shm_Publish(struct SharedMemory *shm, struct CPU *cpu, struct RAM *ram, uint64_t frame) {
+    struct SharedFrame *shared = shm->frame;
+    uint32_t sequence = shared->sequence;
+
+    __atomic_store_n(&shared->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    shared->keypad = cpu->keypad;
+    shared->frame = frame;
+    memcpy(shared->display, ram->display, sizeof(uint8_t) * DISPLAY_SIZE);
+
+    __atomic_store_n(&shared->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+void Shm_ApplyInput(struct SharedMemory *shm, struct CPU *cpu) {
+    uint16_t input = __atomic_load_n(&shm->frame->input, __ATOMIC_RELAXED);
+
+    cpu->keypad = (uint16_t) ((cpu->keypad & ~shm->injected) | input);
+    shm->injected = input;
+}
+
+void Shm_Inject(struct SharedMemory *shm, uint16_t keys) {
+    __atomic_store_n(&shm->frame->input, keys, __ATOMIC_RELAXED);
+}
+
+uint32_t Shm_ReadBegin(const struct SharedFrame *frame) {
+    uint32_t sequence;
+
+    while ((sequence = __atomic_load_n(&frame->sequence, __ATOMIC_ACQUIRE)) & 0x1);
+
+    return sequence;
+}
+
+int Shm_ReadRetry(const struct SharedFrame *frame, uint32_t sequence) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&frame->sequence, __ATOMIC_RELAXED) != sequence;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file shm.h
+ *
+ * Shared memory export of the display, frame counter and keypad of the CHIP8 Emulator
+ */
+
+#ifndef SHM_H
+#define SHM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SHM_MAGIC 0x38504843 // "CHP8"
+#define SHM_VERSION 1
+#define SHM_NAME_SIZE 64
+
+/**
+ * Layout of the POSIX shared memory segment "/chip8-<name>"
+ *
+ * The emulator is the only writer of everything except input. Readers use the sequence lock:
+ *   uint32_t sequence;
+ *   do {
+ *       sequence = Shm_ReadBegin(frame);
+ *       ... read display, frame and keypad in place ...
+ *   } while (Shm_ReadRetry(frame, sequence));
+ */
+struct SharedFrame {
+    uint32_t magic;
+    uint32_t version;
+
+    /**
+     * Sequence Lock
+     * Odd while the emulator is writing a frame, incremented twice per published frame
+     */
+    uint32_t sequence;
+
+    /**
+     * Keypad
+     * keypad: Keys seen by the CPU in the published frame
+     * input: Keys held by external processes, merged into the keypad at the start of every frame
+     */
+    uint16_t keypad;
+    uint16_t input;
+
+    uint64_t frame;
+
+    // Keeps display on its own cache lines
+    uint8_t reserved[40];
+
+    uint8_t display[DISPLAY_SIZE];
+};
+
+struct SharedMemory {
+    char name[SHM_NAME_SIZE];
+
+    struct SharedFrame *frame;
+
+    // Input bits merged into the keypad by the last Shm_ApplyInput
+    uint16_t injected;
+
+    // Set for the emulator which created the segment, it unlinks the segment on close
+    int owner;
+};
+
+/**
+ * Creates the segment for an emulator, fails if one with the same name exists unless force replaces it
+ * Names must not contain '/'
+ */
+struct SharedMemory *createSharedMemory(const char *name, int force);
+
+/**
+ * Maps an existing segment for an external reader
+ */
+struct SharedMemory *Shm_Attach(const char *name);
+
+void Shm_Publish(struct SharedMemory *shm, struct CPU *cpu, struct RAM *ram, uint64_t frame);
+
+/**
+ * Merges the externally injected keys into the keypad, keys released by the injector are released on the CPU too
+ */
+void Shm_ApplyInput(struct SharedMemory *shm, struct CPU *cpu);
+
+void Shm_Inject(struct SharedMemory *shm, uint16_t keys);
+
+uint32_t Shm_ReadBegin(const struct SharedFrame *frame);
+
+int Shm_ReadRetry(const struct SharedFrame *frame, uint32_t sequence);
+
+void Shm_Close(struct SharedMemory *shm);
+
+#endif
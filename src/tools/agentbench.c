@@ -0,0 +1,87 @@
+/**
+ * @file agentbench.c
+ *
+ * Throughput benchmark of the batched agent API of the CHIP8 Emulator
+ *
+ * Usage: chip8_agentbench <rom> [--agents 64] [--frames 1] [--steps 100000] [--downsampled]
+ *
+ * Steps a batch of agents with pseudo random actions and prints agent steps per second on one core.
+ */
+
+#include "../ram/ram.c"
+#include "../cpu/cpu.c"
+#include "../clock/clock.c"
+#include "../agent/agent.c"
+
+int main(int argc, char *args[]) {
+    if (argc < 2) {
+        printf("Usage: %s <rom> [--agents 64] [--frames 1] [--steps 100000] [--downsampled]\n", args[0]);
+        return 2;
+    }
+
+    int count = 64;
+    int frames = 1;
+    long steps = 100000;
+    enum ObservationFormat format = OBSERVATION_PACKED;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(args[i], "--agents") == 0 && i + 1 < argc) {
+            count = atoi(args[++i]);
+        } else if (strcmp(args[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(args[++i]);
+        } else if (strcmp(args[i], "--steps") == 0 && i + 1 < argc) {
+            steps = atol(args[++i]);
+        } else if (strcmp(args[i], "--downsampled") == 0) {
+            format = OBSERVATION_DOWNSAMPLED;
+        }
+    }
+
+    if (count < 1 || frames < 1 || steps < 1) return 2;
+
+    struct Agent **agents = (struct Agent **) malloc(sizeof(struct Agent *) * count);
+    uint16_t *actions = (uint16_t *) malloc(sizeof(uint16_t) * count);
+    uint8_t *observations = (uint8_t *) malloc(Agent_ObservationSize(format) * count);
+    int32_t *rewards = (int32_t *) malloc(sizeof(int32_t) * count);
+
+    for (int i = 0; i < count; i++) {
+        agents[i] = createAgent(args[1], (uint32_t) i + 1);
+
+        if (agents[i] == NULL) {
+            printf("File not found: %s\n", args[1]);
+            return 1;
+        }
+
+        Agent_AddReward(agents[i], 0x200, 1);
+    }
+
+    uint32_t random = 0x9E3779B9;
+    long batches = (steps + count - 1) / count;
+
+    uint64_t start = Clock_Now();
+
+    for (long batch = 0; batch < batches; batch++) {
+        for (int i = 0; i < count; i++) {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            actions[i] = (uint16_t) (1 << (random & 0xF));
+        }
+
+        Agent_StepBatch(agents, actions, count, frames, format, observations, rewards);
+    }
+
+    double elapsed = (double) (Clock_Now() - start) / 1e9;
+    double total = (double) batches * count;
+
+    printf("%.0f agent steps of %d frames in %.3f s: %.2f M steps/s, %.2f M instructions/s\n",
+           total, frames, elapsed, total / elapsed / 1e6, total * frames * CYCLES_PER_FRAME / elapsed / 1e6);
+
+    for (int i = 0; i < count; i++) Agent_Free(agents[i]);
+
+    free(agents);
+    free(actions);
+    free(observations);
+    free(rewards);
+
+    return 0;
+}
@@ -0,0 +1,307 @@
+/**
+ * @file bench.c
+ *
+ * Interpreter throughput benchmark of the CHIP8 Emulator
+ *
+ * Usage: chip8_bench <rom> [--frames 1000000] [--runs 5] [--predecode] [--cache directory] [--debugger [armed]]
+ *                    [--instances N [--pool]]
+ *
+ * Runs the ROM headless without input and prints the best instructions per second over the runs.
+ * --predecode alternates runs of CPU_StepFrame and of CPU_StepFrameDecoded from a table decoded in memory and prints the
+ * median of both, --cache does the same with the table attached from the translation cache and prints the time from
+ * loading the ROM to the end of the first frame. --debugger alternates runs without and with the frame loop of the
+ * emulator with a debugger attached and nothing to break on, and prints the median of both, --debugger armed adds a
+ * breakpoint which is never reached. --instances steps N copies of the
+ * machine one frame each in turn for the given total of frames, allocated with createCPU and createRAM, --pool
+ * alternates those runs with runs from an instance pool and prints the median of both.
+ */
+
+#include "../ram/ram.c"
+#include "../cpu/cpu.c"
+#include "../clock/clock.c"
+#include "../cache/cache.c"
+#include "../debugger/debugger.c"
+#include "../pool/pool.c"
+
+/**
+ * Runs frames from the initial state, through the frame loop of the emulator when debugger is not NULL
+ * and from ram->decoded when decoded is set
+ * @return Instructions per second
+ */
+double Bench_Run(struct CPU *cpu, struct RAM *ram, struct CPU *initialCPU, struct RAM *initialRAM, long frames,
+                 struct Debugger *debugger, int decoded) {
+    *cpu = *initialCPU;
+    memcpy(ram, initialRAM, sizeof(struct RAM));
+
+    uint64_t start = Clock_Now();
+
+    if (debugger != NULL) {
+        for (long frame = 0; frame < frames; frame++) {
+            Debugger_Poll(debugger, cpu, ram);
+
+            if (Debugger_IsArmed(debugger)) {
+                Debugger_StepFrame(debugger, cpu, ram);
+            } else {
+                CPU_StepFrame(cpu, ram);
+            }
+        }
+    } else if (decoded) {
+        for (long frame = 0; frame < frames; frame++) {
+            CPU_StepFrameDecoded(cpu, ram);
+        }
+    } else {
+        for (long frame = 0; frame < frames; frame++) {
+            CPU_StepFrame(cpu, ram);
+        }
+    }
+
+    double elapsed = (double) (Clock_Now() - start) / 1e9;
+
+    return (double) frames * CYCLES_PER_FRAME / elapsed;
+}
+
+int Bench_CompareSpeeds(const void *a, const void *b) {
+    double left = *(const double *) a;
+    double right = *(const double *) b;
+
+    return (left > right) - (left < right);
+}
+
+void Bench_PrintMedians(const char *rom, int runs, const char *baseLabel, double *base, const char *label, double *tested) {
+    qsort(base, runs, sizeof(double), Bench_CompareSpeeds);
+    qsort(tested, runs, sizeof(double), Bench_CompareSpeeds);
+
+    printf("%s: median of %d runs %.2f M instructions/s %s (%.2f-%.2f), %.2f %s (%.2f-%.2f), %+.1f%%\n",
+           rom, runs, base[runs / 2] / 1e6, baseLabel, base[0] / 1e6, base[runs - 1] / 1e6, tested[runs / 2] / 1e6,
+           label, tested[0] / 1e6, tested[runs - 1] / 1e6, 100.0 * (tested[runs / 2] / base[runs / 2] - 1.0));
+}
+
+/**
+ * Alternates runs of the plain interpreter with runs of the configuration under test in one process, swapping the
+ * order every run so drift hits both alike, and prints the median of both
+ */
+void Bench_Compare(const char *rom, const char *label, struct CPU *cpu, struct RAM *ram, struct CPU *initialCPU,
+                   struct RAM *initialRAM, long frames, int runs, struct Debugger *debugger, int decoded) {
+    double *plain = (double *) malloc(sizeof(double) * runs);
+    double *tested = (double *) malloc(sizeof(double) * runs);
+
+    for (int run = 0; run < runs; run++) {
+        if (run % 2 == 0) {
+            plain[run] = Bench_Run(cpu, ram, initialCPU, initialRAM, frames, NULL, 0);
+            tested[run] = Bench_Run(cpu, ram, initialCPU, initialRAM, frames, debugger, decoded);
+        } else {
+            tested[run] = Bench_Run(cpu, ram, initialCPU, initialRAM, frames, debugger, decoded);
+            plain[run] = Bench_Run(cpu, ram, initialCPU, initialRAM, frames, NULL, 0);
+        }
+    }
+
+    Bench_PrintMedians(rom, runs, "plain", plain, label, tested);
+
+    free(plain);
+    free(tested);
+}
+
+/**
+ * Prints the memory layout when report is set
+ * @return Instructions per second over all instances
+ */
+double Bench_Instances(struct CPU *cpu, struct RAM *ram, int instanceCount, long frames, int pooled, int report,
+                       uint64_t *hash) {
+    struct CPU **cpus = (struct CPU **) malloc(sizeof(struct CPU *) * instanceCount);
+    struct RAM **rams = (struct RAM **) malloc(sizeof(struct RAM *) * instanceCount);
+    struct InstancePool *pool = NULL;
+
+    uint64_t setup = Clock_Now();
+
+    if (pooled) {
+        pool = createInstancePool();
+        Pool_SetTemplate(pool, cpu, ram);
+
+        for (int i = 0; i < instanceCount; i++) {
+            struct Instance *instance = Pool_Acquire(pool);
+            cpus[i] = &instance->cpu;
+            rams[i] = &instance->ram;
+        }
+    } else {
+        for (int i = 0; i < instanceCount; i++) {
+            cpus[i] = createCPU();
+            rams[i] = createRAM();
+
+            *cpus[i] = *cpu;
+            memcpy(rams[i], ram, sizeof(struct RAM));
+        }
+    }
+
+    setup = Clock_Now() - setup;
+
+    long rounds = frames / instanceCount > 0 ? frames / instanceCount : 1;
+    uint64_t start = Clock_Now();
+
+    for (long round = 0; round < rounds; round++) {
+        for (int i = 0; i < instanceCount; i++) {
+            CPU_StepFrame(cpus[i], rams[i]);
+        }
+    }
+
+    double elapsed = (double) (Clock_Now() - start) / 1e9;
+
+    *hash = RAM_HashDisplay(rams[instanceCount - 1]);
+
+    if (report && pooled) {
+        printf("Pool: %zu bytes per instance (stride %zu), %d slabs, %d huge page backed, set up in %.1f ms\n",
+               Pool_BytesPerInstance(pool), pool->stride, pool->slabCount, Pool_HugeSlabCount(pool), (double) setup / 1e6);
+    } else if (report) {
+        printf("Malloc: %zu + %zu bytes per instance in two blocks, set up in %.1f ms\n", sizeof(struct CPU),
+               sizeof(struct RAM), (double) setup / 1e6);
+    }
+
+    if (pooled) {
+        Pool_Free(pool);
+    } else {
+        for (int i = 0; i < instanceCount; i++) {
+            free(cpus[i]);
+            free(rams[i]);
+        }
+    }
+
+    free(cpus);
+    free(rams);
+
+    return (double) rounds * instanceCount * CYCLES_PER_FRAME / elapsed;
+}
+
+int main(int argc, char *args[]) {
+    if (argc < 2) {
+        printf("Usage: %s <rom> [--frames 1000000] [--runs 5] [--predecode] [--cache directory] [--debugger [armed]] "
+               "[--instances N [--pool]]\n", args[0]);
+        return 2;
+    }
+
+    long frames = 1000000;
+    int runs = 5;
+    int predecode = 0;
+    int instances = 0;
+    int pooled = 0;
+    const char *cacheDirectory = NULL;
+    struct Debugger *debugger = NULL;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(args[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atol(args[++i]);
+        } else if (strcmp(args[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(args[++i]);
+        } else if (strcmp(args[i], "--cache") == 0 && i + 1 < argc) {
+            cacheDirectory = args[++i];
+        } else if (strcmp(args[i], "--debugger") == 0) {
+            debugger = createDebugger();
+
+            if (i + 1 < argc && strcmp(args[i + 1], "armed") == 0) {
+                debugger->breakpoints[debugger->breakpointCount++] = MEMORY_MASK;
+                i++;
+            }
+        } else if (strcmp(args[i], "--instances") == 0 && i + 1 < argc) {
+            instances = atoi(args[++i]);
+        } else if (strcmp(args[i], "--pool") == 0) {
+            pooled = 1;
+        } else if (strcmp(args[i], "--predecode") == 0) {
+            predecode = 1;
+        }
+    }
+
+    struct CPU *cpu = createCPU();
+    struct RAM *ram = createRAM();
+
+    uint64_t launch = Clock_Now();
+
+    if (RAM_LoadROM(ram, args[1]) < 0) {
+        printf("File not found: %s\n", args[1]);
+        return 1;
+    }
+
+    struct TranslationCache *cache = NULL;
+    struct DecodedOp *table = NULL;
+
+    if (cacheDirectory != NULL) {
+        cache = Cache_Open(cacheDirectory, ram);
+
+        struct CPU firstCPU = *cpu;
+        struct RAM *firstRAM = (struct RAM *) malloc(sizeof(struct RAM));
+        memcpy(firstRAM, ram, sizeof(struct RAM));
+
+        CPU_StepFrameDecoded(&firstCPU, firstRAM);
+
+        printf("First frame after %.1f us (cache %s)\n", (double) (Clock_Now() - launch) / 1e3, cache->hit ? "hit" : "miss");
+
+        free(firstRAM);
+    } else if (predecode) {
+        table = (struct DecodedOp *) malloc(DECODED_TABLE_SIZE);
+        CPU_PredecodeMemory(ram->memory, table);
+        ram->decoded = table;
+    }
+
+    struct CPU initialCPU = *cpu;
+    struct RAM *initialRAM = (struct RAM *) malloc(sizeof(struct RAM));
+    memcpy(initialRAM, ram, sizeof(struct RAM));
+
+    double best = 0;
+    uint64_t hash = 0;
+
+    if (instances > 0 && pooled && runs > 0) {
+        double *allocated = (double *) malloc(sizeof(double) * runs);
+        double *pooledSpeeds = (double *) malloc(sizeof(double) * runs);
+
+        // Alternating like Bench_Compare, the layout is printed once for each
+        for (int run = 0; run < runs; run++) {
+            if (run % 2 == 0) {
+                allocated[run] = Bench_Instances(&initialCPU, initialRAM, instances, frames, 0, run == 0, &hash);
+                pooledSpeeds[run] = Bench_Instances(&initialCPU, initialRAM, instances, frames, 1, run == 0, &hash);
+            } else {
+                pooledSpeeds[run] = Bench_Instances(&initialCPU, initialRAM, instances, frames, 1, 0, &hash);
+                allocated[run] = Bench_Instances(&initialCPU, initialRAM, instances, frames, 0, 0, &hash);
+            }
+        }
+
+        Bench_PrintMedians(args[1], runs, "malloc", allocated, "pool", pooledSpeeds);
+
+        free(allocated);
+        free(pooledSpeeds);
+    }
+
+    for (int run = 0; run < runs && instances > 0 && !pooled; run++) {
+        double speed = Bench_Instances(&initialCPU, initialRAM, instances, frames, 0, run == 0, &hash);
+
+        if (speed > best) best = speed;
+    }
+
+    int decoded = ram->decoded != NULL;
+
+    if (instances <= 0 && debugger != NULL && runs > 0) {
+        Bench_Compare(args[1], "with debugger", cpu, ram, &initialCPU, initialRAM, frames, runs, debugger, 0);
+    } else if (instances <= 0 && decoded && runs > 0) {
+        Bench_Compare(args[1], cache != NULL ? "from cache" : "predecoded", cpu, ram, &initialCPU, initialRAM, frames,
+                      runs, NULL, 1);
+    }
+
+    for (int run = 0; run < runs && instances <= 0 && debugger == NULL && !decoded; run++) {
+        double speed = Bench_Run(cpu, ram, &initialCPU, initialRAM, frames, NULL, 0);
+
+        if (speed > best) best = speed;
+
+        hash = RAM_HashDisplay(ram);
+    }
+
+    if (debugger == NULL && (instances > 0 ? !pooled : !decoded)) {
+        printf("%s: %.2f M instructions/s, display %016llx\n", args[1], best / 1e6, (unsigned long long) hash);
+    }
+
+    if (cache != NULL) Cache_Close(cache, ram);
+
+    if (debugger != NULL) Debugger_Close(debugger);
+
+    free(table);
+    free(initialRAM);
+    free(cpu);
+    free(ram);
+
+    return 0;
+}
@@ -0,0 +1,269 @@
+/**
+ * @file fuzz.c
+ *
+ * Differential fuzzer of the CHIP8 Emulator
+ *
+ * Usage: chip8_fuzz [--roms 1000] [--instructions 100000] [--interval 1024] [--hash] [--seed N] [--rom path]
+ *
+ * Generates random ROMs and random keypad input and runs each one in lockstep on the reference interpreter
+ * and the predecoded engine (see lockstep.h). ROM i is generated from seed + i, so a divergence is reproduced
+ * with --seed <seed + i> --roms 1. The failing ROM is also written next to the working directory.
+ * A machine stuck on one instruction, other than waiting for a key, ends its ROM early.
+ * --rom fuzzes only the input of the given ROM, --hash compares state hashes instead of every field.
+ */
+
+#include <time.h>
+
+#include "../ram/ram.c"
+#include "../cpu/cpu.c"
+#include "../clock/clock.c"
+#include "../lockstep/lockstep.c"
+
+// Chance of a random opcode instead of a valid one, 1 in FUZZ_RAW_OPCODE, unknown opcodes stall the machine
+#define FUZZ_RAW_OPCODE 4096
+// Chance of a keypad change before a frame, 1 in FUZZ_INPUT_CHANGE
+#define FUZZ_INPUT_CHANGE 16
+// Chance of FX33 or FX55 keeping a random I, 1 in FUZZ_INDEX_IN_ROM, stores into the program overwrite code with data
+#define FUZZ_INDEX_IN_ROM 16
+// Highest target of an offset jump, V0 adds up to 0xFF and must not leave the program
+#define FUZZ_OFFSET_JUMP_LIMIT (MEMORY_SIZE - 2 - 0xFF)
+
+struct OpcodeTemplate {
+    uint16_t mask;
+    uint16_t value;
+};
+
+// Fixed bits of every instruction, the remaining bits are random operands
+const struct OpcodeTemplate opcodeTemplates[] = {
+        {0xFFFF, 0x00E0}, {0xFFFF, 0x00EE}, {0xF000, 0x1000}, {0xF000, 0x2000}, {0xF000, 0x3000},
+        {0xF000, 0x4000}, {0xF00F, 0x5000}, {0xF000, 0x6000}, {0xF000, 0x7000}, {0xF00F, 0x8000},
+        {0xF00F, 0x8001}, {0xF00F, 0x8002}, {0xF00F, 0x8003}, {0xF00F, 0x8004}, {0xF00F, 0x8005},
+        {0xF00F, 0x8006}, {0xF00F, 0x8007}, {0xF00F, 0x800E}, {0xF00F, 0x9000}, {0xF000, 0xA000},
+        {0xF000, 0xB000}, {0xF000, 0xC000}, {0xF000, 0xD000}, {0xF0FF, 0xE09E}, {0xF0FF, 0xE0A1},
+        {0xF0FF, 0xF007}, {0xF0FF, 0xF00A}, {0xF0FF, 0xF015}, {0xF0FF, 0xF018}, {0xF0FF, 0xF01E},
+        {0xF0FF, 0xF029}, {0xF0FF, 0xF033}, {0xF0FF, 0xF055}, {0xF0FF, 0xF065}
+};
+
+#define OPCODE_TEMPLATE_COUNT (sizeof(opcodeTemplates) / sizeof(opcodeTemplates[0]))
+
+uint64_t Fuzz_Random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+
+    return *state = x;
+}
+
+/**
+ * @return Even address from ROM_ALLOCATION to limit other than address, a jump to itself stops the machine
+ */
+uint16_t Fuzz_Target(uint64_t random, int address, int limit) {
+    int target = ROM_ALLOCATION + 2 * (int) (random % ((limit - ROM_ALLOCATION) / 2 + 1));
+
+    if (target == address) target = target + 2 <= limit ? target + 2 : ROM_ALLOCATION;
+
+    return (uint16_t) target;
+}
+
+/**
+ * Fills the whole program area. Jump and call targets are even addresses inside it, the font below it
+ * and misaligned code decode to mostly unknown opcodes. Offset jumps are preceded by an even V0, FX33 and FX55
+ * mostly by an I below the program, and the last two instructions jump back so the PC never runs into the font.
+ */
+void Fuzz_GenerateROM(struct RAM *ram, uint64_t *state) {
+    for (int address = ROM_ALLOCATION; address < MEMORY_SIZE; address += 2) {
+        uint64_t random = Fuzz_Random(state);
+        uint16_t opcode = (uint16_t) random;
+
+        if (address >= MEMORY_SIZE - 4) {
+            opcode = (uint16_t) (0x1000 | Fuzz_Target(random >> 32, address, MEMORY_SIZE - 2));
+        } else if ((random >> 16) % FUZZ_RAW_OPCODE != 0) {
+            const struct OpcodeTemplate *template = &opcodeTemplates[(random >> 24) % OPCODE_TEMPLATE_COUNT];
+            opcode = (uint16_t) ((opcode & ~template->mask) | template->value);
+
+            if (template->value == 0x1000 || template->value == 0x2000) {
+                opcode = (uint16_t) (template->value | Fuzz_Target(random >> 32, address, MEMORY_SIZE - 2));
+            } else if (template->value == 0xB000) {
+                opcode = (uint16_t) (0xB000 | Fuzz_Target(random >> 32, address, FUZZ_OFFSET_JUMP_LIMIT));
+
+                // 60NN with an even NN, code reaching the offset jump another way may still see an odd V0
+                if (address > ROM_ALLOCATION) {
+                    ram->memory[address - 2] = 0x60;
+                    ram->memory[address - 1] = (uint8_t) (random >> 40) & 0xFE;
+                }
+            } else if ((template->value == 0xF033 || template->value == 0xF055) && address > ROM_ALLOCATION &&
+                       (random >> 32) % FUZZ_INDEX_IN_ROM != 0) {
+                // ANNN below the program, FX55 stores up to REGISTER_SIZE bytes from I
+                uint16_t index = (uint16_t) ((random >> 40) % (ROM_ALLOCATION - REGISTER_SIZE));
+
+                ram->memory[address - 2] = (uint8_t) (0xA0 | index >> 8);
+                ram->memory[address - 1] = (uint8_t) index;
+            }
+        }
+
+        ram->memory[address] = (uint8_t) (opcode >> 8);
+        ram->memory[address + 1] = (uint8_t) opcode;
+    }
+
+    // Jumps onto an offset jump land on the 60NN before it instead
+    for (int address = ROM_ALLOCATION; address < MEMORY_SIZE; address += 2) {
+        uint8_t kind = ram->memory[address] >> 4;
+        int target = (ram->memory[address] & 0x0F) << 8 | ram->memory[address + 1];
+
+        if ((kind == 0x1 || kind == 0x2 || kind == 0xB) && target > ROM_ALLOCATION && target - 2 != address &&
+            ram->memory[target] >> 4 == 0xB) {
+            ram->memory[address] = (uint8_t) (kind << 4 | (target - 2) >> 8);
+            ram->memory[address + 1] = (uint8_t) (target - 2);
+        }
+    }
+}
+
+/**
+ * @return 1 if the next instruction leaves the machine where it is forever: an unknown opcode or a jump,
+ * call or offset jump to itself. FX0A also stays in place but only until a key is pressed.
+ */
+int Fuzz_IsStuck(struct CPU *cpu, struct RAM *ram) {
+    struct DecodedOp op = CPU_Predecode(CPU_FetchOpCode(cpu, ram));
+
+    switch (op.handler) {
+        case HANDLER_NONE: return 1;
+        case HANDLER_1NNN:
+        case HANDLER_2NNN: return op.nnn == cpu->pc;
+        case HANDLER_BNNN: return op.nnn + cpu->V[0] == cpu->pc;
+        default: return 0;
+    }
+}
+
+uint16_t Fuzz_Keypad(uint64_t *state) {
+    uint64_t random = Fuzz_Random(state);
+
+    // Mostly no key or a single key, sometimes a random chord
+    switch (random & 3) {
+        case 0: return 0;
+        case 1: return (uint16_t) (random >> 16);
+        default: return (uint16_t) (1 << ((random >> 8) & 0xF));
+    }
+}
+
+int main(int argc, char *args[]) {
+    long roms = 1000;
+    long instructions = 100000;
+    int interval = 1024;
+    enum LockstepMode mode = LOCKSTEP_FULL;
+    uint64_t seed = (uint64_t) time(NULL);
+    const char *romPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(args[i], "--roms") == 0 && i + 1 < argc) {
+            roms = atol(args[++i]);
+        } else if (strcmp(args[i], "--instructions") == 0 && i + 1 < argc) {
+            instructions = atol(args[++i]);
+        } else if (strcmp(args[i], "--interval") == 0 && i + 1 < argc) {
+            interval = atoi(args[++i]);
+        } else if (strcmp(args[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(args[++i], NULL, 10);
+        } else if (strcmp(args[i], "--rom") == 0 && i + 1 < argc) {
+            romPath = args[++i];
+        } else if (strcmp(args[i], "--hash") == 0) {
+            mode = LOCKSTEP_HASH;
+        } else {
+            printf("Usage: %s [--roms 1000] [--instructions 100000] [--interval 1024] [--hash] [--seed N] [--rom path]\n",
+                   args[0]);
+            return 2;
+        }
+    }
+
+    struct CPU *cpu = createCPU();
+    struct RAM *ram = createRAM();
+    struct DecodedOp *table = (struct DecodedOp *) malloc(DECODED_TABLE_SIZE);
+
+    if (romPath != NULL && RAM_LoadROM(ram, romPath) < 0) {
+        printf("File not found: %s\n", romPath);
+        return 1;
+    }
+
+    struct CPU initialCPU = *cpu;
+    struct RAM *initialRAM = (struct RAM *) malloc(sizeof(struct RAM));
+    memcpy(initialRAM, ram, sizeof(struct RAM));
+
+    uint64_t total = 0;
+    long stuck = 0;
+    uint64_t start = Clock_Now();
+
+    for (long rom = 0; rom < roms; rom++) {
+        uint64_t romSeed = seed + (uint64_t) rom;
+        // Xorshift must not start from zero
+        uint64_t state = romSeed * 0x9E3779B97F4A7C15ULL | 1;
+
+        *cpu = initialCPU;
+        cpu->seed = (uint32_t) Fuzz_Random(&state) | 1;
+        memcpy(ram, initialRAM, sizeof(struct RAM));
+
+        if (romPath == NULL) {
+            Fuzz_GenerateROM(ram, &state);
+
+            // Returns without a call pop these instead of 0x000, which would run into the font
+            for (int i = 0; i < STACK_SIZE; i++) {
+                cpu->stack[i] = (uint16_t) (ROM_ALLOCATION + Fuzz_Random(&state) % (MEMORY_SIZE - ROM_ALLOCATION)) & 0x0FFE;
+            }
+        }
+
+        CPU_PredecodeMemory(ram->memory, table);
+        ram->decoded = table;
+
+        struct Lockstep *lockstep = createLockstep(cpu, ram, CPU_Step, CPU_StepDecoded, interval, mode);
+
+        int diverged = 0;
+
+        for (long executed = 0; executed < instructions && !diverged; executed += CYCLES_PER_FRAME) {
+            if (Fuzz_Random(&state) % FUZZ_INPUT_CHANGE == 0) {
+                diverged = Lockstep_SetKeypad(lockstep, Fuzz_Keypad(&state));
+            }
+
+            if (!diverged) diverged = Lockstep_Run(lockstep, CYCLES_PER_FRAME);
+
+            if (!diverged && Fuzz_IsStuck(&lockstep->referenceCPU, lockstep->referenceRAM)) {
+                stuck++;
+                break;
+            }
+        }
+
+        if (!diverged) diverged = Lockstep_Check(lockstep);
+
+        total += lockstep->instructions;
+
+        if (diverged) {
+            char path[64];
+            snprintf(path, sizeof(path), "fuzz-%llu.ch8", (unsigned long long) romSeed);
+
+            printf("ROM %ld, reproduce with --seed %llu --roms 1%s%s\n", rom, (unsigned long long) romSeed,
+                   romPath != NULL ? " --rom " : "", romPath != NULL ? romPath : "");
+            Lockstep_Report(lockstep, stdout);
+
+            FILE *file = romPath == NULL ? fopen(path, "wb") : NULL;
+            if (file != NULL) {
+                fwrite(&ram->memory[ROM_ALLOCATION], 1, MEMORY_SIZE - ROM_ALLOCATION, file);
+                fclose(file);
+                printf("ROM written to %s\n", path);
+            }
+
+            Lockstep_Free(lockstep);
+            return 1;
+        }
+
+        Lockstep_Free(lockstep);
+    }
+
+    double elapsed = (double) (Clock_Now() - start) / 1e9;
+
+    printf("%ld ROMs (%ld stuck early), %llu instructions on both engines in %.3f s, %.1f M instructions per second\n",
+           roms, stuck, (unsigned long long) total, elapsed, (double) total / elapsed / 1e6);
+
+    free(table);
+    free(initialRAM);
+    free(cpu);
+    free(ram);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file profile.c
+ *
+ * Call-graph profiler of the CHIP8 Emulator
+ *
+ * Usage: chip8_profile <rom> [--frames 3600] [--keys script] [--time] [--output file]
+ *
+ * Runs the ROM headless and writes folded call stacks weighted by executed instructions, or by sampled host
+ * nanoseconds with --time, e.g. for: chip8_profile pong.ch8 | flamegraph.pl > pong.svg
+ */
+
+#include "../ram/ram.c"
+#include "../cpu/cpu.c"
+#include "../clock/clock.c"
+#include "../script/script.c"
+#include "../profiler/profiler.c"
+
+int main(int argc, char *args[]) {
+    if (argc < 2) {
+        printf("Usage: %s <rom> [--frames 3600] [--keys script] [--time] [--output file]\n", args[0]);
+        return 2;
+    }
+
+    uint32_t frames = 3600;
+    const char *scriptPath = NULL;
+    const char *outputPath = NULL;
+    enum ProfilerWeight weight = PROFILER_INSTRUCTIONS;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(args[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t) strtoul(args[++i], NULL, 10);
+        } else if (strcmp(args[i], "--keys") == 0 && i + 1 < argc) {
+            scriptPath = args[++i];
+        } else if (strcmp(args[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = args[++i];
+        } else if (strcmp(args[i], "--time") == 0) {
+            weight = PROFILER_NANOSECONDS;
+        }
+    }
+
+    struct CPU *cpu = createCPU();
+    struct RAM *ram = createRAM();
+
+    if (RAM_LoadROM(ram, args[1]) < 0) {
+        printf("File not found: %s\n", args[1]);
+        return 1;
+    }
+
+    struct InputScript *script = NULL;
+    if (scriptPath != NULL && (script = Script_Load(scriptPath)) == NULL) {
+        printf("File not found: %s\n", scriptPath);
+        return 1;
+    }
+
+    FILE *output = outputPath != NULL ? fopen(outputPath, "w") : stdout;
+    if (output == NULL) {
+        printf("Can not write: %s\n", outputPath);
+        return 1;
+    }
+
+    struct Profiler *profiler = createProfiler();
+    int cursor = 0;
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        cpu->keypad = Script_KeysAt(script, frame, &cursor);
+
+        Profiler_StepFrame(profiler, cpu, ram);
+    }
+
+    Profiler_WriteFolded(profiler, ram, output, weight);
+
+    if (output != stdout) fclose(output);
+
+    Script_Free(script);
+    free(profiler);
+    free(cpu);
+    free(ram);
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file ramsearch.c
+ *
+ * RAM search tool of the CHIP8 Emulator
+ *
+ * Usage: chip8_ramsearch <rom> [--keys script] [--instances 1] [--threads 1] [--freeze address=value]
+ *                        <frame>:<predicate>[:value[:high]] ...
+ *
+ * Predicates: equal, not-equal, changed, unchanged, increased, decreased, range (see search.h).
+ * Runs the ROM headless on every instance, each with its own random seed, applies each filter when its frame is reached
+ * and prints the addresses which are still candidates on every instance, e.g. for a score going up once:
+ *   chip8_ramsearch pong.ch8 --keys pong.keys 60:unchanged 400:increased:1 800:unchanged
+ */
+
+#include "../ram/ram.c"
+#include "../cpu/cpu.c"
+#include "../clock/clock.c"
+#include "../script/script.c"
+#include "../search/search.c"
+
+#define MAX_FILTERS 64
+
+struct TimedFilter {
+    const char *text;
+    uint32_t frame;
+    struct SearchFilter filter;
+};
+
+int parsePredicate(const char *name, enum SearchPredicate *predicate) {
+    const char *names[] = {"equal", "not-equal", "changed", "unchanged", "increased", "decreased", "range"};
+
+    for (int i = 0; i < 7; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *predicate = (enum SearchPredicate) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int parseFilter(const char *text, struct TimedFilter *filter) {
+    char name[32];
+    unsigned long frame;
+    unsigned int value = 0;
+    unsigned int high = 0xFF;
+
+    if (sscanf(text, "%lu:%31[a-z-]:%i:%i", &frame, name, &value, &high) < 2) return -1;
+    if (parsePredicate(name, &filter->filter.predicate) < 0) return -1;
+
+    filter->text = text;
+    filter->frame = (uint32_t) frame;
+    filter->filter.value = (uint8_t) value;
+    filter->filter.high = (uint8_t) high;
+
+    return 0;
+}
+
+int main(int argc, char *args[]) {
+    if (argc < 3) {
+        printf("Usage: %s <rom> [--keys script] [--instances 1] [--threads 1] [--freeze address=value] "
+               "<frame>:<predicate>[:value[:high]] ...\n", args[0]);
+        return 2;
+    }
+
+    const char *scriptPath = NULL;
+    int instances = 1;
+    int threads = 1;
+
+    struct TimedFilter filters[MAX_FILTERS];
+    int filterCount = 0;
+
+    struct Freeze freezes[SEARCH_MAX_FREEZES];
+    int freezeCount = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(args[i], "--keys") == 0 && i + 1 < argc) {
+            scriptPath = args[++i];
+        } else if (strcmp(args[i], "--instances") == 0 && i + 1 < argc) {
+            instances = atoi(args[++i]);
+        } else if (strcmp(args[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(args[++i]);
+        } else if (strcmp(args[i], "--freeze") == 0 && i + 1 < argc) {
+            unsigned int address, value;
+
+            if (sscanf(args[++i], "%i=%i", &address, &value) != 2 || freezeCount == SEARCH_MAX_FREEZES) {
+                printf("Invalid freeze: %s\n", args[i]);
+                return 2;
+            }
+
+            freezes[freezeCount].address = (uint16_t) address;
+            freezes[freezeCount].value = (uint8_t) value;
+            freezeCount++;
+        } else if (filterCount == MAX_FILTERS || parseFilter(args[i], &filters[filterCount++]) < 0) {
+            printf("Invalid filter: %s\n", args[i]);
+            return 2;
+        }
+    }
+
+    if (instances < 1) instances = 1;
+
+    struct InputScript *script = NULL;
+    if (scriptPath != NULL && (script = Script_Load(scriptPath)) == NULL) {
+        printf("File not found: %s\n", scriptPath);
+        return 1;
+    }
+
+    struct CPU **cpus = (struct CPU **) malloc(sizeof(struct CPU *) * instances);
+    struct RAM **rams = (struct RAM **) malloc(sizeof(struct RAM *) * instances);
+    struct RAMSearch **searches = (struct RAMSearch **) malloc(sizeof(struct RAMSearch *) * instances);
+
+    for (int i = 0; i < instances; i++) {
+        cpus[i] = createCPU();
+        rams[i] = createRAM();
+        cpus[i]->seed = (uint32_t) i + 1;
+
+        if (RAM_LoadROM(rams[i], args[1]) < 0) {
+            printf("File not found: %s\n", args[1]);
+            return 1;
+        }
+
+        searches[i] = createRAMSearch(rams[i]);
+
+        for (int f = 0; f < freezeCount; f++) Search_Freeze(searches[i], freezes[f].address, freezes[f].value);
+    }
+
+    uint32_t frame = 0;
+    int cursor = 0;
+
+    for (int f = 0; f < filterCount; f++) {
+        for (; frame < filters[f].frame; frame++) {
+            uint16_t keys = Script_KeysAt(script, frame, &cursor);
+
+            for (int i = 0; i < instances; i++) {
+                cpus[i]->keypad = keys;
+                CPU_StepFrame(cpus[i], rams[i]);
+                Search_ApplyFreezes(searches[i], rams[i]);
+            }
+        }
+
+        uint64_t start = Clock_Now();
+        Search_FilterBatch(searches, rams, instances, filters[f].filter, threads);
+        double elapsed = (double) (Clock_Now() - start) / 1e9;
+
+        printf("%s: %d candidates on instance 0, %.2f us per instance\n", filters[f].text,
+               searches[0]->candidateCount, elapsed * 1e6 / instances);
+    }
+
+    printf("Candidates on every instance:\n");
+
+    for (int address = 0; address < MEMORY_SIZE; address++) {
+        int candidate = 1;
+
+        for (int i = 0; i < instances && candidate; i++) candidate = searches[i]->candidates[address] != 0;
+
+        if (candidate) printf("0x%03X = 0x%02X\n", address, rams[0]->memory[address]);
+    }
+
+    for (int i = 0; i < instances; i++) {
+        free(searches[i]);
+        free(cpus[i]);
+        free(rams[i]);
+    }
+
+    free(searches);
+    free(cpus);
+    free(rams);
+    Script_Free(script);
+
+    return 0;
+}
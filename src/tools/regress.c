@@ -0,0 +1,386 @@
+/**
+ * @file regress.c
+ *
+ * Headless golden frame-hash regression runner of the CHIP8 Emulator
+ *
+ * Usage: chip8_regress <rom directory> <golden file> [--update] [--frames 60,300,600] [--jobs N]
+ *
+ * Every *.ch8 in the directory is played without a window and without frame pacing, with the keypad
+ * driven by <rom name>.keys when that file exists (see script.h). The display hash is taken after
+ * each listed frame and compared against the golden file, or written to it with --update. Golden entries
+ * of ROMs that are no longer in the directory are reported as stale, --update refuses to run while a ROM
+ * can not be loaded so its entries are not silently dropped.
+ */
+
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "../ram/ram.c"
+#include "../cpu/cpu.c"
+#include "../clock/clock.c"
+#include "../script/script.c"
+
+#define MAX_CHECKPOINTS 32
+#define MAX_NAME_LENGTH 256
+#define MAX_PATH_LENGTH 1024
+
+enum RegressStatus {
+    REGRESS_PASS,
+    REGRESS_FAIL,
+    REGRESS_NEW,
+    REGRESS_ERROR
+};
+
+struct RegressJob {
+    char name[MAX_NAME_LENGTH];
+    enum RegressStatus status;
+    uint64_t hashes[MAX_CHECKPOINTS];
+};
+
+struct GoldenEntry {
+    char name[MAX_NAME_LENGTH];
+    uint32_t frame;
+    uint64_t hash;
+};
+
+struct RegressContext {
+    const char *directory;
+
+    struct RegressJob *jobs;
+    int jobCount;
+    int nextJob;
+    pthread_mutex_t lock;
+
+    uint32_t frames[MAX_CHECKPOINTS];
+    int frameCount;
+};
+
+void runJob(struct RegressContext *context, struct RegressJob *job) {
+    char path[MAX_PATH_LENGTH];
+
+    struct CPU *cpu = createCPU();
+    struct RAM *ram = createRAM();
+
+    snprintf(path, sizeof(path), "%s/%s", context->directory, job->name);
+
+    // An empty read, e.g. from a directory, is no ROM either
+    if (RAM_LoadROM(ram, path) <= 0) {
+        job->status = REGRESS_ERROR;
+        free(cpu);
+        free(ram);
+        return;
+    }
+
+    // pong.ch8 -> pong.keys
+    snprintf(path, sizeof(path), "%s/%.*s.keys", context->directory, (int) (strlen(job->name) - 4), job->name);
+    struct InputScript *script = Script_Load(path);
+    int cursor = 0;
+
+    uint32_t lastFrame = context->frames[context->frameCount - 1];
+    int checkpoint = 0;
+
+    for (uint32_t frame = 0; frame < lastFrame; frame++) {
+        cpu->keypad = Script_KeysAt(script, frame, &cursor);
+
+        CPU_StepFrame(cpu, ram);
+
+        while (checkpoint < context->frameCount && context->frames[checkpoint] == frame + 1) {
+            job->hashes[checkpoint++] = RAM_HashDisplay(ram);
+        }
+    }
+
+    job->status = REGRESS_PASS;
+
+    Script_Free(script);
+    free(cpu);
+    free(ram);
+}
+
+void *runWorker(void *argument) {
+    struct RegressContext *context = (struct RegressContext *) argument;
+
+    while (1) {
+        pthread_mutex_lock(&context->lock);
+        int index = context->nextJob++;
+        pthread_mutex_unlock(&context->lock);
+
+        if (index >= context->jobCount) break;
+
+        runJob(context, &context->jobs[index]);
+    }
+
+    return NULL;
+}
+
+int compareJobs(const void *a, const void *b) {
+    return strcmp(((const struct RegressJob *) a)->name, ((const struct RegressJob *) b)->name);
+}
+
+int compareFrames(const void *a, const void *b) {
+    uint32_t left = *(const uint32_t *) a;
+    uint32_t right = *(const uint32_t *) b;
+
+    return (left > right) - (left < right);
+}
+
+int listROMs(struct RegressContext *context) {
+    DIR *directory = opendir(context->directory);
+
+    if (directory == NULL) return -1;
+
+    int capacity = 64;
+    context->jobs = (struct RegressJob *) malloc(sizeof(struct RegressJob) * capacity);
+    context->jobCount = 0;
+
+    struct dirent *entry;
+    while ((entry = readdir(directory)) != NULL) {
+        size_t length = strlen(entry->d_name);
+
+        if (length < 5 || length >= MAX_NAME_LENGTH || strcmp(entry->d_name + length - 4, ".ch8") != 0) continue;
+
+        if (context->jobCount == capacity) {
+            capacity *= 2;
+            context->jobs = (struct RegressJob *) realloc(context->jobs, sizeof(struct RegressJob) * capacity);
+        }
+
+        struct RegressJob *job = &context->jobs[context->jobCount++];
+        memset(job, 0, sizeof(struct RegressJob));
+        strcpy(job->name, entry->d_name);
+    }
+
+    closedir(directory);
+
+    qsort(context->jobs, context->jobCount, sizeof(struct RegressJob), compareJobs);
+
+    return context->jobCount;
+}
+
+int loadGolden(const char *path, struct GoldenEntry **entries) {
+    FILE *file = fopen(path, "r");
+
+    *entries = NULL;
+
+    if (file == NULL) return 0;
+
+    int capacity = 64;
+    int count = 0;
+    *entries = (struct GoldenEntry *) malloc(sizeof(struct GoldenEntry) * capacity);
+
+    char line[MAX_PATH_LENGTH];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        struct GoldenEntry entry;
+        unsigned long frame;
+        unsigned long long hash;
+
+        if (line[0] == '#' || sscanf(line, "%255s %lu %llx", entry.name, &frame, &hash) != 3) continue;
+
+        entry.frame = (uint32_t) frame;
+        entry.hash = (uint64_t) hash;
+
+        if (count == capacity) {
+            capacity *= 2;
+            *entries = (struct GoldenEntry *) realloc(*entries, sizeof(struct GoldenEntry) * capacity);
+        }
+
+        (*entries)[count++] = entry;
+    }
+
+    fclose(file);
+
+    return count;
+}
+
+int writeGolden(const char *path, struct RegressContext *context) {
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL) return -1;
+
+    fprintf(file, "# <rom> <frame> <display hash>\n");
+
+    for (int i = 0; i < context->jobCount; i++) {
+        struct RegressJob *job = &context->jobs[i];
+
+        for (int k = 0; k < context->frameCount; k++) {
+            fprintf(file, "%s %u %016llx\n", job->name, context->frames[k], (unsigned long long) job->hashes[k]);
+        }
+    }
+
+    fclose(file);
+
+    return 0;
+}
+
+void checkGolden(struct RegressContext *context, struct GoldenEntry *entries, int entryCount) {
+    for (int i = 0; i < context->jobCount; i++) {
+        struct RegressJob *job = &context->jobs[i];
+
+        if (job->status == REGRESS_ERROR) {
+            printf("ERROR %s: can not be loaded\n", job->name);
+            continue;
+        }
+
+        for (int k = 0; k < context->frameCount; k++) {
+            struct GoldenEntry *golden = NULL;
+
+            for (int e = 0; e < entryCount; e++) {
+                if (entries[e].frame == context->frames[k] && strcmp(entries[e].name, job->name) == 0) {
+                    golden = &entries[e];
+                    break;
+                }
+            }
+
+            if (golden == NULL) {
+                job->status = REGRESS_NEW;
+            } else if (golden->hash != job->hashes[k]) {
+                printf("FAIL %s: frame %u expected %016llx got %016llx\n", job->name, context->frames[k],
+                       (unsigned long long) golden->hash, (unsigned long long) job->hashes[k]);
+                job->status = REGRESS_FAIL;
+            }
+        }
+
+        if (job->status == REGRESS_NEW) printf("NEW %s: no golden hash, run with --update\n", job->name);
+    }
+}
+
+/**
+ * Reports every ROM with golden entries that is not in the directory
+ * @return Number of such ROMs
+ */
+int checkStale(struct RegressContext *context, struct GoldenEntry *entries, int entryCount, int update) {
+    int stale = 0;
+
+    for (int e = 0; e < entryCount; e++) {
+        // Entries of one ROM are written next to each other
+        if (e > 0 && strcmp(entries[e].name, entries[e - 1].name) == 0) continue;
+
+        int found = 0;
+        for (int i = 0; i < context->jobCount && !found; i++) {
+            found = strcmp(context->jobs[i].name, entries[e].name) == 0;
+        }
+
+        if (!found) {
+            printf("STALE %s: not in the directory, %s\n", entries[e].name,
+                   update ? "golden hashes dropped" : "run with --update to drop its golden hashes");
+            stale++;
+        }
+    }
+
+    return stale;
+}
+
+int parseFrames(struct RegressContext *context, const char *list) {
+    context->frameCount = 0;
+
+    while (*list != '\0' && context->frameCount < MAX_CHECKPOINTS) {
+        char *end;
+        unsigned long frame = strtoul(list, &end, 10);
+
+        if (end == list || frame == 0) return -1;
+
+        context->frames[context->frameCount++] = (uint32_t) frame;
+
+        list = (*end == ',') ? end + 1 : end;
+    }
+
+    qsort(context->frames, context->frameCount, sizeof(uint32_t), compareFrames);
+
+    return context->frameCount;
+}
+
+int main(int argc, char *args[]) {
+    if (argc < 3) {
+        printf("Usage: %s <rom directory> <golden file> [--update] [--frames 60,300,600] [--jobs N]\n", args[0]);
+        return 2;
+    }
+
+    struct RegressContext context;
+    memset(&context, 0, sizeof(context));
+    context.directory = args[1];
+
+    const char *goldenPath = args[2];
+    const char *frameList = "60,300,600";
+    int update = 0;
+    int workerCount = (int) sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(args[i], "--update") == 0) {
+            update = 1;
+        } else if (strcmp(args[i], "--frames") == 0 && i + 1 < argc) {
+            frameList = args[++i];
+        } else if (strcmp(args[i], "--jobs") == 0 && i + 1 < argc) {
+            workerCount = atoi(args[++i]);
+        }
+    }
+
+    if (parseFrames(&context, frameList) <= 0) {
+        printf("Invalid frame list: %s\n", frameList);
+        return 2;
+    }
+
+    if (listROMs(&context) < 0) {
+        printf("Directory not found: %s\n", context.directory);
+        return 2;
+    }
+
+    if (workerCount < 1) workerCount = 1;
+    if (workerCount > context.jobCount) workerCount = context.jobCount;
+
+    uint64_t start = Clock_Now();
+
+    pthread_mutex_init(&context.lock, NULL);
+
+    pthread_t *workers = (pthread_t *) malloc(sizeof(pthread_t) * (workerCount + 1));
+    for (int i = 0; i < workerCount; i++) pthread_create(&workers[i], NULL, runWorker, &context);
+    for (int i = 0; i < workerCount; i++) pthread_join(workers[i], NULL);
+
+    pthread_mutex_destroy(&context.lock);
+
+    double elapsed = (double) (Clock_Now() - start) / 1e9;
+
+    int result = 0;
+
+    struct GoldenEntry *entries;
+    int entryCount = loadGolden(goldenPath, &entries);
+
+    if (update) {
+        for (int i = 0; i < context.jobCount; i++) {
+            if (context.jobs[i].status != REGRESS_ERROR) continue;
+
+            printf("ERROR %s: can not be loaded\n", context.jobs[i].name);
+            result = 1;
+        }
+
+        if (result != 0) {
+            printf("Golden file not updated: %s\n", goldenPath);
+        } else if (writeGolden(goldenPath, &context) < 0) {
+            printf("Can not write golden file: %s\n", goldenPath);
+            result = 2;
+        } else {
+            checkStale(&context, entries, entryCount, update);
+        }
+    } else {
+        checkGolden(&context, entries, entryCount);
+
+        if (checkStale(&context, entries, entryCount, update) > 0) result = 1;
+
+        for (int i = 0; i < context.jobCount; i++) {
+            if (context.jobs[i].status != REGRESS_PASS) result = 1;
+        }
+    }
+
+    free(entries);
+
+    int passed = 0;
+    for (int i = 0; i < context.jobCount; i++) {
+        if (context.jobs[i].status == REGRESS_PASS) passed++;
+    }
+
+    printf("%d/%d ROMs %s, %u frames each in %.3f s on %d threads\n", passed, context.jobCount,
+           !update ? "passed" : result == 0 ? "recorded" : "run", context.frames[context.frameCount - 1], elapsed, workerCount);
+
+    free(workers);
+    free(context.jobs);
+
+    return result;
+}
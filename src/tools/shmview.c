@@ -0,0 +1,56 @@
+/**
+ * @file shmview.c
+ *
+ * Reader of the shared memory export of the CHIP8 Emulator
+ *
+ * Usage: chip8_shmview <name> [--keys HEX]
+ *
+ * Attaches to the segment of an emulator started with --shm <name>, optionally injects a keypad mask
+ * and prints the latest consistent frame.
+ */
+
+#include "../ram/ram.c"
+#include "../cpu/cpu.c"
+#include "../shm/shm.c"
+
+int main(int argc, char *args[]) {
+    if (argc < 2) {
+        printf("Usage: %s <name> [--keys HEX]\n", args[0]);
+        return 2;
+    }
+
+    struct SharedMemory *shm = Shm_Attach(args[1]);
+
+    if (shm == NULL) return 1;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(args[i], "--keys") == 0 && i + 1 < argc) {
+            Shm_Inject(shm, (uint16_t) strtoul(args[++i], NULL, 16));
+        }
+    }
+
+    char screen[32 * 65 + 1];
+    uint64_t frame;
+    uint16_t keypad;
+    uint32_t sequence;
+
+    do {
+        sequence = Shm_ReadBegin(shm->frame);
+
+        frame = shm->frame->frame;
+        keypad = shm->frame->keypad;
+
+        for (int i = 0; i < DISPLAY_SIZE; i++) {
+            screen[(i / 64) * 65 + (i % 64)] = shm->frame->display[i] ? '#' : '.';
+        }
+    } while (Shm_ReadRetry(shm->frame, sequence));
+
+    for (int y = 0; y < 32; y++) screen[y * 65 + 64] = '\n';
+    screen[32 * 65] = '\0';
+
+    printf("frame %llu keypad %04x\n%s", (unsigned long long) frame, keypad, screen);
+
+    Shm_Close(shm);
+
+    return 0;
+}
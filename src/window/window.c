@@ -29,8 +29,14 @@ struct EmulatorWindow *createWindow(int argc, char *args[]) {
     window->instance = instance;
     window->surface = surface;
     window->renderer = renderer;
+    window->latency = NULL;
+    window->presentedHash = 0;
     window->quit = 0;
 
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(args[i], "--latency") == 0) window->latency = createLatencyTracker();
+    }
+
     Window_LoadAudio(window);
 
     return window;
@@ -57,6 +63,13 @@ void Window_RenderDisplay(struct EmulatorWindow *window, struct RAM *ram) {
     }
 
     SDL_RenderPresent(window->renderer);
+
+    if (window->latency != NULL) {
+        uint64_t hash = RAM_HashDisplay(ram);
+
+        Latency_FramePresented(window->latency, Clock_Now(), hash != window->presentedHash);
+        window->presentedHash = hash;
+    }
 }
 
 void Window_ListenEvents(struct EmulatorWindow *window, struct CPU *cpu) {
@@ -69,16 +82,22 @@ void Window_ListenEvents(struct EmulatorWindow *window, struct CPU *cpu) {
             case SDL_QUIT:
                 window->quit = 1;
                 break;
-            case SDL_KEYUP:
+            case SDL_KEYDOWN:
                 keyPad = Window_DecodeKeyPad(event.key.keysym.scancode);
                 if (keyPad != 0xFF) {
-                    cpu->keypad[keyPad] = 1;
+                    cpu->keypad |= (uint16_t) (1 << keyPad);
+
+                    if (window->latency != NULL && event.key.repeat == 0) {
+                        // Event timestamps are in milliseconds since SDL_Init, move them onto the nanosecond clock
+                        uint64_t age = (uint64_t) (SDL_GetTicks() - event.key.timestamp) * 1000000;
+                        Latency_KeyEvent(window->latency, Clock_Now() - age);
+                    }
                 }
                 break;
-            case SDL_KEYDOWN:
+            case SDL_KEYUP:
                 keyPad = Window_DecodeKeyPad(event.key.keysym.scancode);
                 if (keyPad != 0xFF) {
-                    cpu->keypad[keyPad] = 0;
+                    cpu->keypad &= (uint16_t) ~(1 << keyPad);
                 }
                 break;
         }
@@ -88,6 +107,11 @@ void Window_ListenEvents(struct EmulatorWindow *window, struct CPU *cpu) {
 }
 
 void Window_Close(struct EmulatorWindow *window) {
+    if (window->latency != NULL) {
+        Latency_Report(window->latency, stdout);
+        Latency_Free(window->latency);
+    }
+
     SDL_CloseAudio();
     SDL_FreeWAV(window->audioBuffer),
             SDL_DestroyRenderer(window->renderer);
@@ -164,4 +188,4 @@ uint8_t Window_DecodeKeyPad(uint16_t scancode) {
     }
 
     return 0xFF;
-}
\ No newline at end of file
+}
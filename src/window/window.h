@@ -29,6 +29,13 @@ struct EmulatorWindow {
     uint8_t *audioBuffer;
     uint32_t audioLength;
 
+    /**
+     * Input-to-photon latency, enabled with --latency
+     * Display hash of the last presented frame tells whether a frame changed
+     */
+    struct LatencyTracker *latency;
+    uint64_t presentedHash;
+
     int quit;
 };
 